@@ -26,11 +26,13 @@ void idt_init() {
     idt_p = get_idt_base();
 
     // Add an entry for each interrupt into the IDT
+    idt_entry_add(PAGE_FAULT_INTR, kisr_entry_page_fault);
     idt_entry_add(TIMER_INTR, kisr_entry_timer);
+    idt_entry_add(KEYBOARD_INTR, kisr_entry_keyboard);
     idt_entry_add(SYSCALL_INTR, kisr_entry_syscall);
 
-    // Clear the PIC mask to enable interrupts
-    outportb(0x21, ~1);
+    // Clear the PIC mask to enable interrupts (IRQ 0 and IRQ 1)
+    outportb(0x21, ~3);
 }
 
 /**
@@ -8,6 +8,8 @@
 #ifndef IPC_H
 #define IPC_H
 
+#include "global.h"
+
 //Semaphore definitions
 typedef enum {
     SEMAPHORE_UNINITIALIZED = -1,
@@ -17,13 +19,59 @@ typedef enum {
 typedef int sem_t;
 
 // Message definitions
-#define MSG_SIZE 256
+#define MSG_SIZE 256                // Data bytes in a msg_t
+#define MSG_SIZE_MAX 4096           // Largest message a mailbox accepts
 
 typedef struct msg_t {
-    int sender;                     // Sending PID
-    int time_sent;                  // Time sent
-    int time_received;              // Time Received
+    int sender;                     // Sending PID (set by the kernel)
+    int time_sent;                  // Time sent (set by the kernel)
+    int time_received;              // Time Received (set by the kernel)
+    int size;                       // Number of data bytes
     unsigned char data[MSG_SIZE];   // Message data
 } msg_t;
 
+// Bytes in front of the message data
+#define MSG_HEADER_SIZE (sizeof(msg_t) - MSG_SIZE)
+
+// Declares a message type with room for n data bytes, for messages larger
+// than a msg_t; pass it to msg_send/msg_recv_size cast to msg_t *
+#define MSG_DEFINE(name, n)                                                 \
+typedef struct {                                                            \
+    int sender;                                                             \
+    int time_sent;                                                          \
+    int time_received;                                                      \
+    int size;                                                               \
+    unsigned char data[n];                                                  \
+} name
+
+// Returned by a timed wait whose deadline passed first
+#define IPC_TIMEOUT -2
+
+// Timeout that waits forever
+#define IPC_FOREVER -1
+
+// Words in a bit set with one bit per process; there are as many
+// mailboxes and semaphores as processes
+#define IPC_SET_WORDS ((PROC_MAX + 31) / 32)
+
+// Set of mailboxes and semaphores waited on by msg_select
+typedef struct {
+    unsigned int mbox[IPC_SET_WORDS];   // mailbox numbers
+    unsigned int sem[IPC_SET_WORDS];    // semaphore ids
+} ipc_set_t;
+
+// Adds n to, or tests for n in, one half of an ipc_set_t (or any bit set)
+#define IPC_SET_ADD(words, n) ((words)[(n) / 32] |= 1u << ((n) % 32))
+#define IPC_SET_DEL(words, n) ((words)[(n) / 32] &= ~(1u << ((n) % 32)))
+#define IPC_SET_HAS(words, n) (((words)[(n) / 32] >> ((n) % 32)) & 1)
+
+// Most messages moved by a single msg_sendv or msg_recvv call
+#define MSG_BATCH_MAX 64
+
+// msg_recvv flags
+#define MSG_NOWAIT 0x1              // Return 0 rather than wait if empty
+
+// Most pages that can be loaned in a single message
+#define MSG_PAGES_MAX 256
+
 #endif
@@ -0,0 +1,237 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Earliest Deadline First Scheduling Class
+ *
+ * Each admitted process reserves a runtime budget every period. The
+ * runnable process with the earliest absolute deadline always runs, ahead
+ * of every process managed by the scheduler policy. A process that uses
+ * up its budget is throttled on the timer wheel until its next period so
+ * it cannot starve the rest of the system.
+ */
+#include "spede.h"
+#include "kernel.h"
+#include "ktimer.h"
+#include "kedf.h"
+
+// Runnable processes
+int edf_q[PROC_MAX];
+int edf_q_size;
+
+// Total utilization reserved by admitted processes in parts per thousand
+int edf_util;
+
+/**
+ * Computes the utilization of a reservation in parts per thousand
+ */
+int kedf_util(int period, int runtime) {
+    return (runtime * 1000 + period - 1) / period;
+}
+
+/**
+ * Records a deadline miss for the current job, once per job
+ * @param pid - the process id
+ */
+void kedf_check_miss(int pid) {
+    if (!pcb[pid].dl_missed && system_time > pcb[pid].dl_abs_deadline) {
+        pcb[pid].dl_missed = 1;
+        pcb[pid].dl_misses++;
+    }
+}
+
+/**
+ * Initializes the EDF class
+ */
+void kedf_init() {
+    edf_q_size = 0;
+    edf_util = 0;
+}
+
+/**
+ * Admits a process into the EDF class
+ * @param pid      - the process id
+ * @param period   - activation period in ticks
+ * @param runtime  - CPU budget per period in ticks
+ * @param deadline - deadline relative to the start of each period in ticks
+ * @return -1 if the parameters are invalid or the process cannot be
+ *         admitted without exceeding EDF_UTIL_MAX; 0 on success
+ */
+int kedf_admit(int pid, int period, int runtime, int deadline) {
+    int util;
+
+    if (period <= 0 || runtime <= 0 || runtime > deadline || deadline > period) {
+        return -1;
+    }
+
+    // Utilization based admission control
+    util = kedf_util(period, runtime);
+    if (pcb[pid].sched_class == SCHED_EDF) {
+        util -= kedf_util(pcb[pid].dl_period, pcb[pid].dl_runtime);
+    }
+
+    if (edf_util + util > EDF_UTIL_MAX) {
+        return -1;
+    }
+
+    edf_util += util;
+
+    pcb[pid].sched_class = SCHED_EDF;
+    pcb[pid].dl_period = period;
+    pcb[pid].dl_runtime = runtime;
+    pcb[pid].dl_deadline = deadline;
+
+    // The first period starts now
+    pcb[pid].dl_period_start = system_time;
+    pcb[pid].dl_abs_deadline = system_time + deadline;
+    pcb[pid].dl_budget = runtime;
+    pcb[pid].dl_missed = 0;
+
+    return 0;
+}
+
+/**
+ * Releases the utilization reserved by a process in the EDF class
+ * @param pid - the process id
+ */
+void kedf_release(int pid) {
+    if (pcb[pid].sched_class != SCHED_EDF) {
+        return;
+    }
+
+    edf_util -= kedf_util(pcb[pid].dl_period, pcb[pid].dl_runtime);
+}
+
+/**
+ * Adds a process that has become runnable, replenishing its budget if a
+ * new period has started
+ * @param pid - the process id
+ */
+void kedf_enqueue(int pid) {
+    int periods;
+
+    // Move to the most recent period boundary
+    if (system_time >= pcb[pid].dl_period_start + pcb[pid].dl_period) {
+        periods = (system_time - pcb[pid].dl_period_start) / pcb[pid].dl_period;
+        pcb[pid].dl_period_start += periods * pcb[pid].dl_period;
+        pcb[pid].dl_abs_deadline = pcb[pid].dl_period_start + pcb[pid].dl_deadline;
+        pcb[pid].dl_budget = pcb[pid].dl_runtime;
+        pcb[pid].dl_missed = 0;
+    }
+
+    edf_q[edf_q_size++] = pid;
+}
+
+/**
+ * Returns a preempted process to the run queue, or throttles it until
+ * its next period if the budget has been used up
+ * @param pid - the process id
+ */
+void kedf_yield(int pid) {
+    if (pcb[pid].dl_budget > 0) {
+        edf_q[edf_q_size++] = pid;
+        return;
+    }
+
+    // The job is unfinished; throttled until replenished at the start of
+    // the next period
+    pcb[pid].dl_overruns++;
+    pcb[pid].state = SLEEPING;
+    ktimer_add(pid, pcb[pid].dl_period_start + pcb[pid].dl_period);
+}
+
+/**
+ * Ends the current job of the active process, which sleeps until its
+ * next period starts
+ * @param pid - the process id
+ */
+void kedf_finish(int pid) {
+    kedf_check_miss(pid);
+
+    pcb[pid].state = SLEEPING;
+    ktimer_add(pid, pcb[pid].dl_period_start + pcb[pid].dl_period);
+}
+
+/**
+ * Removes a specific runnable process
+ * @param pid - the process id
+ */
+void kedf_remove(int pid) {
+    int i;
+
+    for (i = 0; i < edf_q_size; i++) {
+        if (edf_q[i] == pid) {
+            edf_q[i] = edf_q[--edf_q_size];
+            return;
+        }
+    }
+}
+
+/**
+ * Finds the position of the runnable process with the earliest deadline
+ * @return index into edf_q; -1 if nothing is runnable
+ */
+int kedf_earliest() {
+    int i;
+    int min = -1;
+
+    for (i = 0; i < edf_q_size; i++) {
+        if (min < 0 || pcb[edf_q[i]].dl_abs_deadline < pcb[edf_q[min]].dl_abs_deadline) {
+            min = i;
+        }
+    }
+
+    return min;
+}
+
+/**
+ * Removes the runnable process with the earliest deadline
+ * @return the process id; -1 if nothing is runnable
+ */
+int kedf_pick_next() {
+    int min;
+    int pid;
+
+    min = kedf_earliest();
+    if (min < 0) {
+        return -1;
+    }
+
+    pid = edf_q[min];
+    edf_q[min] = edf_q[--edf_q_size];
+
+    kedf_check_miss(pid);
+
+    return pid;
+}
+
+/**
+ * Charges CPU time against the budget of the active process
+ * @param pid   - the process id
+ * @param ticks - number of ticks the process ran
+ */
+void kedf_tick(int pid, int ticks) {
+    pcb[pid].dl_budget -= ticks;
+
+    kedf_check_miss(pid);
+}
+
+/**
+ * Determines if the active EDF process must give up the CPU
+ * @param pid - the active process id
+ * @return 1 if the process should be preempted; 0 otherwise
+ */
+int kedf_check_preempt(int pid) {
+    int min;
+
+    // Budget has been used up for this period
+    if (pcb[pid].dl_budget <= 0) {
+        return 1;
+    }
+
+    // A process with an earlier deadline has become runnable
+    min = kedf_earliest();
+
+    return min >= 0 && pcb[edf_q[min]].dl_abs_deadline < pcb[pid].dl_abs_deadline;
+}
@@ -0,0 +1,91 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Earliest Deadline First Scheduling Class
+ */
+#ifndef KEDF_H
+#define KEDF_H
+
+// Maximum total utilization of the EDF class in parts per thousand
+#ifndef EDF_UTIL_MAX
+#define EDF_UTIL_MAX 950
+#endif
+
+// Number of runnable processes in the EDF class
+extern int edf_q_size;
+
+// Total utilization reserved by admitted processes in parts per thousand
+extern int edf_util;
+
+/**
+ * Initializes the EDF class
+ */
+void kedf_init();
+
+/**
+ * Admits a process into the EDF class
+ * @param pid      - the process id
+ * @param period   - activation period in ticks
+ * @param runtime  - CPU budget per period in ticks
+ * @param deadline - deadline relative to the start of each period in ticks
+ * @return -1 if the parameters are invalid or the process cannot be
+ *         admitted without exceeding EDF_UTIL_MAX; 0 on success
+ */
+int kedf_admit(int pid, int period, int runtime, int deadline);
+
+/**
+ * Releases the utilization reserved by a process in the EDF class
+ * @param pid - the process id
+ */
+void kedf_release(int pid);
+
+/**
+ * Adds a process that has become runnable, replenishing its budget if a
+ * new period has started
+ * @param pid - the process id
+ */
+void kedf_enqueue(int pid);
+
+/**
+ * Returns a preempted process to the run queue, or throttles it until
+ * its next period if the budget has been used up
+ * @param pid - the process id
+ */
+void kedf_yield(int pid);
+
+/**
+ * Ends the current job of the active process, which sleeps until its
+ * next period starts
+ * @param pid - the process id
+ */
+void kedf_finish(int pid);
+
+/**
+ * Removes a specific runnable process
+ * @param pid - the process id
+ */
+void kedf_remove(int pid);
+
+/**
+ * Removes the runnable process with the earliest deadline
+ * @return the process id; -1 if nothing is runnable
+ */
+int kedf_pick_next();
+
+/**
+ * Charges CPU time against the budget of the active process
+ * @param pid   - the process id
+ * @param ticks - number of ticks the process ran
+ */
+void kedf_tick(int pid, int ticks);
+
+/**
+ * Determines if the active EDF process must give up the CPU
+ * @param pid - the active process id
+ * @return 1 if the process should be preempted; 0 otherwise
+ */
+int kedf_check_preempt(int pid);
+
+#endif
@@ -13,7 +13,16 @@
 #include "kproc.h"
 #include "queue.h"
 #include "kisr.h"
+#include "ktimer.h"
+#include "kfair.h"
+#include "ksched.h"
+#include "kedf.h"
+#include "kkbd.h"
+#include "kmem.h"
+#include "kpage.h"
+#include "kshm.h"
 #include "user_proc.h"
+#include "user_bench.h"
 #include "ipc.h"
 #include "syscall.h"
 #include "string.h"
@@ -33,9 +42,6 @@ void kdata_init();
 // Current system time
 int system_time;
 
-// runtime stacks of processes
-char stack[PROC_MAX][PROC_STACK_SIZE];
-
 // process table
 pcb_t pcb[PROC_MAX];
 
@@ -47,12 +53,14 @@ int active_pid = -1;
 
 // Process queues
 queue_t available_q;
-queue_t run_q;
-queue_t idle_q;
-queue_t sleep_q;
+plist_t run_q[PRIO_LEVELS];
+unsigned int run_q_map;
+plist_t idle_q;
 queue_t semaphore_q;
+int sem_boosts;
 semaphore_t semaphores[SEMAPHORE_MAX];
-mailbox_t mailboxes[MBOX_MAX];
+mailbox_t *mailboxes[MBOX_MAX];
+kslab_cache_t mbox_cache;
 
 /**
  * Kernel Initialization
@@ -60,63 +68,78 @@ mailbox_t mailboxes[MBOX_MAX];
  */
 void kernel_init() {
     size_t i = 0;
-    int j=0;
     cons_printf("Initializing kernel data structures\n");
 
     // Initialize system time
 	system_time = 0;
 
     //initializing the queues 
+    printf("Initialization page frames\n");
+    kmem_init();
+    printf("Initialization paging\n");
+    kpage_init();
+    kshm_init();
+    printf("Initialization slab caches\n");
+    kslab_init();
+    kslab_cache_init(&mbox_cache, "mailbox", sizeof(mailbox_t));
     printf("Initialization queue\n");
     queue_init(&available_q);
-    printf("Initialization run queue\n");
-    queue_init(&run_q);
-    printf("Initialization sleep queue\n");
-    queue_init(&sleep_q);
+    printf("Initialization scheduler\n");
+    ksched_init(SCHED_POLICY);
+    kedf_init();
+    printf("Initialization timer wheel\n");
+    ktimer_init();
+    printf("Initialization keyboard\n");
+    kkbd_init();
     printf("Initialization idle queue\n");
-    queue_init(&idle_q);
+    plist_init(&idle_q);
     printf("Initialization semaphore queue\n");
     queue_init(&semaphore_q);
+    sem_boosts = 0;
 
     for(i = 0; i<PROC_MAX;i++){
         semaphores[i].count = 0;
-        semaphores[i].init =  SEMAPHORE_INITIALIZED;
-        queue_init(&semaphores[i].wait_q);
-        for(j = 0;j<MBOX_SIZE;j++){
-            mailboxes[i].messages[j].sender = 0;
-            mailboxes[i].messages[j].time_sent = 0;
-            mailboxes[i].messages[j].time_received = 0;
-            sp_memset(&mailboxes[i].messages[j].data,0,MSG_SIZE);
-        } 
-        mailboxes[i].head = 0;
-        mailboxes[i].tail = 0;
-        mailboxes[i].size = 0;
-        queue_init(&mailboxes[i].wait_q);
+        semaphores[i].init = SEMAPHORE_UNINITIALIZED;
+        semaphores[i].holder = -1;
+        plist_init(&semaphores[i].wait_q);
+        sp_memset(semaphores[i].select_pids, 0, sizeof(semaphores[i].select_pids));
+        semaphores[i].select_count = 0;
+        queue_in(&semaphore_q, i);
+        mailboxes[i] = NULL;
         pcb[i].state =AVAILABLE;
         pcb[i].active_time = 0;
         pcb[i].total_time = 0;
+        pcb[i].sched_class = SCHED_PRIO;
+        pcb[i].priority = PRIO_DEFAULT;
+        pcb[i].base_priority = PRIO_DEFAULT;
+        pcb[i].blocked_on = -1;
+        pcb[i].nice = 0;
+        pcb[i].weight = NICE_0_WEIGHT;
+        pcb[i].vruntime = 0;
+        pcb[i].fair_index = -1;
+        pcb[i].pass = 0;
+        pcb[i].dl_overruns = 0;
+        pcb[i].dl_misses = 0;
+        pcb[i].quantum = PROC_TICKS_MAX;
+        pcb[i].switches_voluntary = 0;
+        pcb[i].switches_involuntary = 0;
         pcb[i].trapframe_p = 0;
+        pcb[i].stack = NULL;
+        pcb[i].stack_va = NULL;
+        pcb[i].stack_size = 0;
+        pcb[i].page_dir = NULL;
+        pcb[i].heap_brk = 0;
+        pcb[i].shm_attached = 0;
+        sp_memset(&pcb[i].select, 0, sizeof(ipc_set_t));
+        pcb[i].timer_slot = NULL;
+        pcb[i].timer_next = TIMER_NONE;
+        pcb[i].timer_prev = TIMER_NONE;
         sp_memset(&pcb[i].name, 0,PROC_NAME_LEN);
         queue_in(&available_q, i);
-        pcb[i].queue = &available_q;
+        pcb[i].queue = NULL;
+        pcb[i].list_next = PLIST_NONE;
+        pcb[i].list_prev = PLIST_NONE;
     }
-
-    //Feeding queues
-    // queue_init(&available_q);
-    // queue_init(&run_q);
-    queue_in(&available_q,0);
-    queue_in(&available_q,1);
-    queue_in(&available_q,2);
-    queue_in(&available_q,3);
-    queue_in(&available_q,4);
-    queue_in(&available_q,5);
-    queue_in(&available_q,6);
-    queue_in(&available_q,7);
-    queue_in(&available_q,8);
-    queue_in(&available_q,9);
-    queue_in(&available_q,10);
-    queue_in(&available_q,11);
-    queue_in(&available_q,12);
 }
 /**
  * Kernel run loop
@@ -127,7 +150,9 @@ void kernel_init() {
  * @param  trapframe - pointer to the current trapframe
  */
 void kernel_run(trapframe_t *trapframe) {
-    char key;
+    char keys[KBD_BUF_SIZE];
+    int count;
+    int i;
 
     // If we do not have a valid PID, then panic
     if (active_pid < 0 || active_pid > PID_MAX) {
@@ -135,7 +160,8 @@ void kernel_run(trapframe_t *trapframe) {
     }
 
     // save the trapframe into the PCB of the currently running process
-    pcb[active_pid].trapframe_p = trapframe;
+    // (the kernel reaches every stack through its identity mapped alias)
+    pcb[active_pid].trapframe_p = KPAGE_STACK_KVA(active_pid, trapframe);
 
     // Process the current interrupt and call the appropriate service routine
     switch (trapframe->interrupt) {
@@ -143,6 +169,14 @@ void kernel_run(trapframe_t *trapframe) {
         case TIMER_INTR:
             kisr_timer();
             break;
+
+        case KEYBOARD_INTR:
+            kisr_keyboard();
+            break;
+
+        case PAGE_FAULT_INTR:
+            kisr_page_fault();
+            break;
         
         case SYSCALL_INTR:
             kisr_syscall();
@@ -153,11 +187,11 @@ void kernel_run(trapframe_t *trapframe) {
             break;
     }
 
-    // Process special developer/debug commands
-    if (cons_kbhit()) {
-        key = cons_getchar();
+    // Process special developer/debug commands buffered by the keyboard ISR
+    count = kkbd_drain(keys, KBD_BUF_SIZE);
 
-        switch (key) {
+    for (i = 0; i < count; i++) {
+        switch (keys[i]) {
             case 'b':
                 // Set a breakpoint
                 breakpoint();
@@ -165,7 +199,32 @@ void kernel_run(trapframe_t *trapframe) {
 
             case 'n':
                 // Create a new process
-                kproc_exec("user_proc", &user_proc, &run_q);
+                kproc_exec("user_proc", &user_proc, &run_q[PRIO_DEFAULT]);
+                break;
+
+            case 'f':
+                // Benchmark process spawn/exit throughput
+                kproc_exec("bench_spawn", &bench_spawn_proc, &run_q[PRIO_DEFAULT]);
+                break;
+
+            case 'g':
+                // Benchmark a trivial system call (get_proc_pid)
+                kproc_exec("bench_syscall", &bench_syscall_proc, &run_q[PRIO_DEFAULT]);
+                break;
+
+            case 's':
+                // Benchmark scheduler pick-next cost and wakeup latency
+                kproc_exec("bench_sched", &bench_sched_proc, &run_q[PRIO_DEFAULT]);
+                break;
+
+            case 't':
+                // Benchmark timer wakeup lateness with many sleepers
+                kproc_exec("bench_timer", &bench_timer_proc, &run_q[PRIO_DEFAULT]);
+                break;
+
+            case 'm':
+                // Benchmark message throughput by batch size
+                kproc_exec("bench_msg", &bench_msg_proc, &run_q[PRIO_DEFAULT]);
                 break;
 
             case 'p':
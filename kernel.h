@@ -11,6 +11,9 @@
 
 #include "global.h"
 #include "queue.h"
+#include "ring.h"
+#include "kslab.h"
+#include "plist.h"
 #include "trapframe.h"
 #include "syscall_common.h"
 #include "ipc.h"
@@ -20,20 +23,44 @@
 // Maximum process ID possible (0-based PIDs)
 #define PID_MAX PROC_MAX-1
 
-// Process runtime stack size
-#define PROC_STACK_SIZE 8196
+// Default process runtime stack size
+#define PROC_STACK_SIZE 8192
+
+// Value written at the bottom of each stack to detect overflows
+#define PROC_STACK_CANARY 0x5AFEC0DE
+
+// Check each process' stack canary on every timer tick
+#ifndef PROC_STACK_CHECK
+#define PROC_STACK_CHECK 1
+#endif
+
+// Fill each new stack so its high-water mark can be measured; this makes
+// process creation cost proportional to the stack size
+#ifndef PROC_STACK_WATERMARK
+#define PROC_STACK_WATERMARK 0
+#endif
+
+// Byte used to fill stacks when measuring the high-water mark
+#define PROC_STACK_FILL 0xFF
 
 // Maximum number of ticks a process may run before being rescheduled
 #define PROC_TICKS_MAX 50
 
+// Number of scheduling priority levels (0 is the highest priority)
+// Must not exceed the number of bits in run_q_map
+#define PRIO_LEVELS 32
+
+// Default priority assigned to new processes
+#define PRIO_DEFAULT 16
+
 // Maximum number of semaphores
 #define SEMAPHORE_MAX PROC_MAX
 
 // Maximum number of mailboxes
 #define MBOX_MAX PROC_MAX
 
-// Size of each mailbox
-#define MBOX_SIZE PROC_MAX
+// Page loans each mailbox can hold (rounded up to a power of two)
+#define MBOX_SIZE RING_POW2(PROC_MAX)
 
 
 /**
@@ -50,16 +77,60 @@ typedef enum {
 } state_t;
 
 
+// Scheduling classes
+typedef enum {
+    SCHED_PRIO,                     // fixed priority, round robin within a level
+    SCHED_FAIR,                     // weighted fair share by virtual runtime
+    SCHED_EDF                       // earliest deadline first, above all others
+} sched_class_t;
+
+
 // The process control block for each process
 typedef struct {
     char name[PROC_NAME_LEN+1];     // Process name/title
 
     state_t state;                  // current process state
-    queue_t *queue;                 // queue the process belongs to
+    plist_t *queue;                 // list the process belongs to
+    int list_next;                  // next process in the list
+    int list_prev;                  // previous process in the list
 
     int active_time;                // current cpu time while active
     int total_time;                 // total cpu time since created
+    int quantum;                    // ticks the process may run before being preempted
+    int switches_voluntary;         // times the process blocked or exited
+    int switches_involuntary;       // times the process was preempted
     int wake_time;                  // time that the process should "wake up"
+    int *timer_slot;                // timer wheel slot while sleeping
+    int timer_next;                 // next process in the timer slot
+    int timer_prev;                 // previous process in the timer slot
+
+    sched_class_t sched_class;      // scheduling class
+    int priority;                   // scheduling priority (0 is highest)
+    int base_priority;              // priority before any inheritance boost
+    int blocked_on;                 // semaphore the process waits on, -1 if none
+    int nice;                       // nice value for the fair class
+    int weight;                     // fair class weight derived from nice
+    unsigned int vruntime;          // fair class virtual runtime
+    int fair_index;                 // position in the fair class run queue
+    unsigned int pass;              // stride policy pass value
+
+    int dl_period;                  // EDF activation period in ticks
+    int dl_runtime;                 // EDF budget per period in ticks
+    int dl_deadline;                // EDF deadline relative to the period start
+    int dl_period_start;            // start time of the current period
+    int dl_abs_deadline;            // absolute deadline of the current job
+    int dl_budget;                  // budget remaining in the current period
+    int dl_missed;                  // current job has missed its deadline
+    int dl_overruns;                // jobs that used up the budget unfinished
+    int dl_misses;                  // number of missed deadlines
+
+    char *stack;                    // runtime stack (page frames)
+    char *stack_va;                 // runtime stack as mapped for the process
+    int stack_size;                 // runtime stack size in bytes
+    unsigned int *page_dir;         // page directory of the address space
+    unsigned int heap_brk;          // end of the demand-zero heap
+    unsigned int shm_attached;      // mask of attached shared memory segments
+    ipc_set_t select;               // mailboxes and semaphores waited on by msg_select
 
     trapframe_t *trapframe_p;       // process trapframe
     syscall_t *syscall_p; 
@@ -70,17 +141,52 @@ typedef struct {
 typedef struct {
     int count;                      // Semaphore count
     int init;                       // Indicates if initialized
-    queue_t wait_q;                 // Wait queue for the semaphore
+    int holder;                     // Process holding the semaphore, -1 if none
+    plist_t wait_q;                 // Wait queue for the semaphore
+    unsigned int select_pids[IPC_SET_WORDS]; // Processes waiting in msg_select
+    int select_count;               // Number of processes in select_pids
 } semaphore_t;
 
 
 // Mailbox data structures
+// Queued messages are stored back to back in a byte ring, each as a header
+// followed by its data. The ring is allocated on the first message queued
+// and doubles in size when a message does not fit
+#define MBOX_BYTES_MIN 256
+#define MBOX_BYTES_MAX 8192
+
+// Queued message header; same layout as the start of msg_t
+typedef struct {
+    int sender;                     // Sending PID
+    int time_sent;                  // Time sent
+    int time_received;              // Time received
+    int size;                       // Number of data bytes
+} mbox_hdr_t;
+
+// Loaned pages in transit; the frames move from the sender's heap to the
+// receiver's without being copied
 typedef struct {
-    msg_t messages[MBOX_SIZE];      // Incoming messages
-    int head;                       // First message
-    int tail;                       // Last message
-    int size;                       // Total messages
-    queue_t wait_q;                 // Processes waiting for messages
+    int sender;                     // Sending PID
+    int pages;                      // Number of page frames
+    unsigned int frames[1];         // Page frame addresses (pages entries)
+} msg_pages_t;
+
+typedef msg_pages_t *msg_pages_ptr_t;
+
+RING_DEFINE(mbox_page_ring, msg_pages_ptr_t, MBOX_SIZE)
+
+// Mailboxes are allocated from mbox_cache on first use
+typedef struct {
+    unsigned char *buf;             // Incoming message bytes; NULL if none yet
+    unsigned int bytes;             // Size of buf (a power of two)
+    unsigned int head;              // Bytes removed from the ring
+    unsigned int tail;              // Bytes added to the ring
+    int count;                      // Messages queued
+    plist_t wait_q;                 // Processes waiting for messages
+    mbox_page_ring_t loans;         // Incoming loaned pages
+    plist_t loan_wait_q;            // Processes waiting for loaned pages
+    unsigned int select_pids[IPC_SET_WORDS]; // Processes waiting in msg_select
+    int select_count;               // Number of processes in select_pids
 } mailbox_t;
 
 
@@ -88,8 +194,6 @@ typedef struct {
  * Kernel data structures - available to the entire kernel
  */
 
-// runtime stacks of processes
-extern char stack[PROC_MAX][PROC_STACK_SIZE];
 
 // process table
 extern pcb_t pcb[PROC_MAX];
@@ -102,16 +206,26 @@ extern int active_pid;
 
 // Process queues
 extern queue_t available_q;
-extern queue_t run_q;
-extern queue_t idle_q;
-extern queue_t sleep_q;
+extern plist_t run_q[PRIO_LEVELS];
+extern unsigned int run_q_map;      // bit n is set when run_q[n] is not empty
+extern plist_t idle_q;
+
+// Context switch statistics
+extern int sched_switches_voluntary;
+extern int sched_switches_involuntary;
+
+// Idle statistics
+extern int idle_ticks;              // ticks spent in the idle task
+extern int idle_halts;              // times the idle task halted the CPU
 
 // Semaphore Data Stuctures
 extern semaphore_t semaphores[SEMAPHORE_MAX];
 extern queue_t semaphore_q;
+extern int sem_boosts;              // priority inheritance boosts applied
 
 // Mailbox Data Structures
-extern mailbox_t mailboxes[MBOX_MAX];
+extern mailbox_t *mailboxes[MBOX_MAX];
+extern kslab_cache_t mbox_cache;
 
 /**
  * Function declarations
@@ -0,0 +1,184 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Fair Share Scheduling Class
+ *
+ * Runnable processes are kept in a binary min-heap ordered by virtual
+ * runtime. Each tick a process runs advances its virtual runtime in
+ * inverse proportion to its weight, so always running the process with
+ * the smallest virtual runtime hands out CPU time in proportion to the
+ * weights.
+ */
+#include "spede.h"
+#include "kernel.h"
+#include "kfair.h"
+
+// Weights for each nice value, NICE_MIN to NICE_MAX
+// Each step is roughly a 10% change in CPU share
+int fair_weights[NICE_MAX - NICE_MIN + 1] = {
+    88761, 71755, 56483, 46273, 36291,
+    29154, 23254, 18705, 14949, 11916,
+     9548,  7620,  6100,  4904,  3906,
+     3121,  2501,  1991,  1586,  1277,
+     1024,   820,   655,   526,   423,
+      335,   272,   215,   172,   137,
+      110,    87,    70,    56,    45,
+       36,    29,    23,    18,    15
+};
+
+// Min-heap of runnable process ids
+int fair_q[PROC_MAX];
+int fair_q_size;
+
+// Smallest virtual runtime seen in the run queue; never decreases
+unsigned int fair_min_vruntime;
+
+/**
+ * Compares virtual runtimes, tolerating wraparound
+ * @return 1 if pid a should run before pid b; 0 otherwise
+ */
+int kfair_before(int a, int b) {
+    return (int)(pcb[a].vruntime - pcb[b].vruntime) < 0;
+}
+
+/**
+ * Places a process at a heap position
+ */
+void kfair_set(int index, int pid) {
+    fair_q[index] = pid;
+    pcb[pid].fair_index = index;
+}
+
+/**
+ * Moves the process at a heap position up towards the root
+ */
+void kfair_sift_up(int index) {
+    int pid = fair_q[index];
+    int parent;
+
+    while (index > 0) {
+        parent = (index - 1) / 2;
+        if (!kfair_before(pid, fair_q[parent])) {
+            break;
+        }
+        kfair_set(index, fair_q[parent]);
+        index = parent;
+    }
+
+    kfair_set(index, pid);
+}
+
+/**
+ * Moves the process at a heap position down towards the leaves
+ */
+void kfair_sift_down(int index) {
+    int pid = fair_q[index];
+    int child;
+
+    while ((child = index * 2 + 1) < fair_q_size) {
+        if (child + 1 < fair_q_size && kfair_before(fair_q[child + 1], fair_q[child])) {
+            child++;
+        }
+        if (!kfair_before(fair_q[child], pid)) {
+            break;
+        }
+        kfair_set(index, fair_q[child]);
+        index = child;
+    }
+
+    kfair_set(index, pid);
+}
+
+/**
+ * Initializes the fair class run queue
+ */
+void kfair_init() {
+    fair_q_size = 0;
+    fair_min_vruntime = 0;
+}
+
+/**
+ * Obtains the weight for a nice value
+ * @param  nice - nice value, NICE_MIN to NICE_MAX
+ * @return the weight
+ */
+int kfair_weight(int nice) {
+    if (nice < NICE_MIN) {
+        nice = NICE_MIN;
+    } else if (nice > NICE_MAX) {
+        nice = NICE_MAX;
+    }
+
+    return fair_weights[nice - NICE_MIN];
+}
+
+/**
+ * Adds a runnable process to the fair class run queue
+ * @param pid - the process id
+ */
+void kfair_enqueue(int pid) {
+    // Processes that slept or just joined may not bank CPU time
+    if ((int)(pcb[pid].vruntime - fair_min_vruntime) < 0) {
+        pcb[pid].vruntime = fair_min_vruntime;
+    }
+
+    fair_q_size++;
+    kfair_set(fair_q_size - 1, pid);
+    kfair_sift_up(fair_q_size - 1);
+}
+
+/**
+ * Removes the process with the smallest virtual runtime
+ * @return the process id; -1 if the run queue is empty
+ */
+int kfair_dequeue() {
+    int pid;
+
+    if (fair_q_size == 0) {
+        return -1;
+    }
+
+    pid = fair_q[0];
+    kfair_remove(pid);
+
+    return pid;
+}
+
+/**
+ * Removes a specific process from the fair class run queue
+ * @param pid - the process id
+ */
+void kfair_remove(int pid) {
+    int index = pcb[pid].fair_index;
+    int moved;
+
+    if (index < 0 || index >= fair_q_size || fair_q[index] != pid) {
+        return;
+    }
+
+    pcb[pid].fair_index = -1;
+    fair_q_size--;
+
+    // Fill the hole with the last entry and restore the heap order
+    if (index < fair_q_size) {
+        moved = fair_q[fair_q_size];
+        kfair_set(index, moved);
+        kfair_sift_down(index);
+        kfair_sift_up(pcb[moved].fair_index);
+    }
+
+    if (fair_q_size > 0 && (int)(pcb[fair_q[0]].vruntime - fair_min_vruntime) > 0) {
+        fair_min_vruntime = pcb[fair_q[0]].vruntime;
+    }
+}
+
+/**
+ * Charges CPU time to a process in the fair class
+ * @param pid   - the process id
+ * @param ticks - number of ticks the process ran
+ */
+void kfair_account(int pid, int ticks) {
+    pcb[pid].vruntime += (unsigned int)ticks * FAIR_VRUNTIME_SCALE * NICE_0_WEIGHT / pcb[pid].weight;
+}
@@ -0,0 +1,61 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Fair Share Scheduling Class
+ */
+#ifndef KFAIR_H
+#define KFAIR_H
+
+// Range of nice values for the fair scheduling class
+#define NICE_MIN -20
+#define NICE_MAX 19
+
+// Weight of a process with a nice value of 0
+#define NICE_0_WEIGHT 1024
+
+// Virtual runtime units charged per tick to a nice 0 process
+#define FAIR_VRUNTIME_SCALE 1024
+
+// Number of runnable processes in the fair class
+extern int fair_q_size;
+
+/**
+ * Initializes the fair class run queue
+ */
+void kfair_init();
+
+/**
+ * Obtains the weight for a nice value
+ * @param  nice - nice value, NICE_MIN to NICE_MAX
+ * @return the weight
+ */
+int kfair_weight(int nice);
+
+/**
+ * Adds a runnable process to the fair class run queue
+ * @param pid - the process id
+ */
+void kfair_enqueue(int pid);
+
+/**
+ * Removes the process with the smallest virtual runtime
+ * @return the process id; -1 if the run queue is empty
+ */
+int kfair_dequeue();
+
+/**
+ * Removes a specific process from the fair class run queue
+ * @param pid - the process id
+ */
+void kfair_remove(int pid);
+
+/**
+ * Charges CPU time to a process in the fair class
+ * @param pid   - the process id
+ * @param ticks - number of ticks the process ran
+ */
+void kfair_account(int pid, int ticks);
+
+#endif
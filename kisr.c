@@ -13,12 +13,19 @@
 #include "syscall.h"
 #include "syscall_common.h"
 #include "kutil.h"
+#include "ktimer.h"
+#include "kproc.h"
+#include "ksched.h"
+#include "kedf.h"
+#include "kkbd.h"
+#include "kpage.h"
 
 
 /**
  * Kernel Interrupt Service Routine: Timer (IRQ 0)
  */
 void kisr_timer() {
+    int ticks;
 
     /*
         {
@@ -28,17 +35,102 @@ void kisr_timer() {
         }
 	
 */
+    // Catch up on any ticks skipped while running tickless
+    ticks = ktimer_ticks_elapsed();
+
+	if(active_pid == 0){
+		idle_ticks += ticks;
+	}
+
 	if(active_pid > 0){
-		pcb[active_pid].active_time++;
-		pcb[active_pid].total_time++;
+		pcb[active_pid].active_time += ticks;
+		pcb[active_pid].total_time += ticks;
+
+		// Charge the time to the process in its scheduling class
+		if(pcb[active_pid].sched_class == SCHED_EDF){
+			kedf_tick(active_pid, ticks);
+		}else{
+			sched_ops->tick(active_pid, ticks);
+		}
+
+#if PROC_STACK_CHECK
+		// The frames below an overrun stack may belong to anything
+		if(kproc_stack_check(active_pid) != 0){
+			panic("Process stack overflow");
+		}
+#endif
 	}
-    // Increment the system time
-    system_time++;
+    // Advance the system time
+    system_time += ticks;
+
+    // Wake up any sleeping processes that are due
+    ktimer_tick();
 
     // Dismiss IRQ 0 (Timer)
     outportb(0x20, 0x60);
 }
 
+/**
+ * Kernel Interrupt Service Routine: Keyboard (IRQ 1)
+ */
+void kisr_keyboard() {
+    // Hand the scan code to the kernel through the keyboard ring
+    kkbd_isr();
+
+    // Dismiss IRQ 1 (Keyboard)
+    outportb(0x20, 0x61);
+}
+
+/**
+ * Kernel Interrupt Service Routine: Page Fault (exception 14)
+ */
+void kisr_page_fault() {
+    unsigned int addr;
+
+    addr = get_cr2();
+
+    // Map a demand-zero page and let the process retry the access
+    if (kpage_fault(active_pid, addr, page_fault_error) == 0) {
+        return;
+    }
+
+    if (active_pid == 0) {
+        panic("Page fault in the idle task");
+    }
+
+    printf("Page fault at 0x%x in process %d\n", addr, active_pid);
+    kproc_exit(active_pid);
+}
+
+/**
+ * Classifies a system call as blocking or non-blocking
+ * Non-blocking system calls never change the active process or make a
+ * higher priority process runnable, so the scheduler can be skipped
+ * @param  syscall - the system call number
+ * @return 1 if the system call may block or reschedule; 0 otherwise
+ */
+int kisr_syscall_blocking(int syscall) {
+    switch (syscall) {
+      case SYSCALL_GET_SYS_TIME:
+      case SYSCALL_GET_PROC_PID:
+      case SYSCALL_GET_PROC_NAME:
+      case SYSCALL_SEM_INIT:
+      case SYSCALL_SET_PROC_QUANTUM:
+      case SYSCALL_GET_IDLE_STATS:
+      case SYSCALL_SCHED_GET_DEADLINE_STATS:
+      case SYSCALL_GET_MEM_STATS:
+      case SYSCALL_GET_STACK_STATS:
+      case SYSCALL_PROC_SBRK:
+      case SYSCALL_SHM_CREATE:
+      case SYSCALL_SHM_ATTACH:
+      case SYSCALL_SHM_DETACH:
+          return 0;
+
+      default:
+          return 1;
+    }
+}
+
 void kisr_syscall(){
   int syscall;
 
@@ -82,9 +174,77 @@ void kisr_syscall(){
       case SYSCALL_MSG_RECV:
            ksyscall_msg_recv();
           break;   
+      case SYSCALL_SET_PROC_PRIO:
+           ksyscall_set_proc_prio();
+          break;
+      case SYSCALL_SET_PROC_QUANTUM:
+           ksyscall_set_proc_quantum();
+          break;
+      case SYSCALL_SET_PROC_NICE:
+           ksyscall_set_proc_nice();
+          break;
+      case SYSCALL_GET_IDLE_STATS:
+           ksyscall_get_idle_stats();
+          break;
+      case SYSCALL_SCHED_SET_DEADLINE:
+           ksyscall_sched_set_deadline();
+          break;
+      case SYSCALL_SCHED_GET_DEADLINE_STATS:
+           ksyscall_sched_get_deadline_stats();
+          break;
+      case SYSCALL_SCHED_YIELD_PERIOD:
+           ksyscall_sched_yield_period();
+          break;
+      case SYSCALL_GET_MEM_STATS:
+           ksyscall_get_mem_stats();
+          break;
+      case SYSCALL_GET_STACK_STATS:
+           ksyscall_get_stack_stats();
+          break;
+      case SYSCALL_PROC_SBRK:
+           ksyscall_proc_sbrk();
+          break;
+      case SYSCALL_PROC_FORK:
+           ksyscall_proc_fork();
+          break;
+      case SYSCALL_SHM_CREATE:
+           ksyscall_shm_create();
+          break;
+      case SYSCALL_SHM_ATTACH:
+           ksyscall_shm_attach();
+          break;
+      case SYSCALL_SHM_DETACH:
+           ksyscall_shm_detach();
+          break;
+      case SYSCALL_MSG_SEND_PAGES:
+           ksyscall_msg_send_pages();
+          break;
+      case SYSCALL_MSG_RECV_PAGES:
+           ksyscall_msg_recv_pages();
+          break;
+      case SYSCALL_MSG_SENDV:
+           ksyscall_msg_sendv();
+          break;
+      case SYSCALL_MSG_RECVV:
+           ksyscall_msg_recvv();
+          break;
+      case SYSCALL_MSG_RECV_TIMEOUT:
+           ksyscall_msg_recv_timeout();
+          break;
+      case SYSCALL_SEM_TIMEDWAIT:
+           ksyscall_sem_timedwait();
+          break;
+      case SYSCALL_MSG_SELECT:
+           ksyscall_msg_select();
+          break;
 
       default:
            panic("Invalid Syscall");
           break;
     }
+
+    // Return straight to the caller for non-blocking system calls
+    if (SYSCALL_FAST_RETURN && !kisr_syscall_blocking(syscall)) {
+        kproc_load(KPAGE_STACK_UVA(active_pid, pcb[active_pid].trapframe_p));
+    }
 }
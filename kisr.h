@@ -13,7 +13,9 @@
  */
 
 // Interrupt definitions
+#define PAGE_FAULT_INTR 0x0E // Page fault exception
 #define TIMER_INTR 0x20     // Timer interrupt
+#define KEYBOARD_INTR 0x21  // Keyboard interrupt
 #define SYSCALL_INTR 0x80   // System call interrupt
 
 // kernel's stack size in bytes
@@ -25,6 +27,12 @@
 // kernel's data segment
 #define KDATA 0x10
 
+// Returns from non-blocking system calls without running the scheduler
+// (set to 0 to compare against the full kernel_run path)
+#ifndef SYSCALL_FAST_RETURN
+#define SYSCALL_FAST_RETURN 1
+#endif
+
 
 #ifndef ASSEMBLER
 /**
@@ -33,6 +41,10 @@
 
 // Timer ISR
 void kisr_timer();
+// Keyboard ISR
+void kisr_keyboard();
+// Page fault ISR
+void kisr_page_fault();
 // Syscall ISR
 void kisr_syscall();
 
@@ -41,6 +53,8 @@ __BEGIN_DECLS
 
 // Kernel interrupt entries
 extern void kisr_entry_timer();
+extern void kisr_entry_keyboard();
+extern void kisr_entry_page_fault();
 extern void kisr_entry_syscall();
 
 __END_DECLS
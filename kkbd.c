@@ -0,0 +1,85 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Keyboard Driver
+ *
+ * The keyboard ISR only moves the raw scan code into a single-producer/
+ * single-consumer ring. Translation to characters happens when the kernel
+ * drains the ring, so the ISR stays short and never touches kernel state.
+ */
+#include "spede.h"
+#include "kernel.h"
+#include "kkbd.h"
+
+// Scan code set 1 to character translation for unshifted key presses
+// Keys without a printable character translate to 0
+char kbd_keymap[KBD_RELEASE] = {
+    0,    0x1b, '1',  '2',  '3',  '4',  '5',  '6',      // 0x00
+    '7',  '8',  '9',  '0',  '-',  '=',  '\b', '\t',     // 0x08
+    'q',  'w',  'e',  'r',  't',  'y',  'u',  'i',      // 0x10
+    'o',  'p',  '[',  ']',  '\n', 0,    'a',  's',      // 0x18
+    'd',  'f',  'g',  'h',  'j',  'k',  'l',  ';',      // 0x20
+    '\'', '`',  0,    '\\', 'z',  'x',  'c',  'v',      // 0x28
+    'b',  'n',  'm',  ',',  '.',  '/',  0,    '*',      // 0x30
+    0,    ' '                                           // 0x38
+};
+
+kbd_ring_t kbd_ring;
+int kbd_dropped;
+
+/**
+ * Initializes the keyboard ring
+ */
+void kkbd_init() {
+    kbd_ring_init(&kbd_ring);
+    kbd_dropped = 0;
+}
+
+/**
+ * Reads a scan code from the keyboard controller into the ring
+ * Called from the keyboard interrupt service routine
+ */
+void kkbd_isr() {
+    unsigned char code;
+
+    // The controller must be read even if the code is dropped
+    code = inportb(KBD_DATA);
+
+    if (kbd_ring_put(&kbd_ring, &code) != 0) {
+        kbd_dropped++;
+    }
+}
+
+/**
+ * Drains buffered key presses as characters
+ * @param  keys - destination for the characters
+ * @param  max  - maximum number of characters to store
+ * @return the number of characters stored
+ */
+int kkbd_drain(char *keys, int max) {
+    unsigned char codes[KBD_BUF_SIZE];
+    int count;
+    int i;
+    int n;
+
+    if (max > KBD_BUF_SIZE) {
+        max = KBD_BUF_SIZE;
+    }
+
+    // Take everything buffered in one pass
+    count = kbd_ring_drain(&kbd_ring, codes, max);
+
+    n = 0;
+    for (i = 0; i < count; i++) {
+        // Ignore key releases and keys without a character
+        if ((codes[i] & KBD_RELEASE) || kbd_keymap[codes[i]] == 0) {
+            continue;
+        }
+
+        keys[n++] = kbd_keymap[codes[i]];
+    }
+
+    return n;
+}
@@ -0,0 +1,47 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Keyboard Driver
+ */
+#ifndef KKBD_H
+#define KKBD_H
+
+#include "spsc.h"
+
+// 8042 keyboard controller
+#define KBD_DATA 0x60                   // data port
+#define KBD_RELEASE 0x80                // scan code bit set on key release
+
+// Number of scan codes buffered between the ISR and the kernel
+#define KBD_BUF_SIZE 64
+
+SPSC_DEFINE(kbd_ring, unsigned char, KBD_BUF_SIZE)
+
+// Scan codes written by the ISR and read by the kernel
+extern kbd_ring_t kbd_ring;
+
+// Number of scan codes dropped because the ring was full
+extern int kbd_dropped;
+
+/**
+ * Initializes the keyboard ring
+ */
+void kkbd_init();
+
+/**
+ * Reads a scan code from the keyboard controller into the ring
+ * Called from the keyboard interrupt service routine
+ */
+void kkbd_isr();
+
+/**
+ * Drains buffered key presses as characters
+ * @param  keys - destination for the characters
+ * @param  max  - maximum number of characters to store
+ * @return the number of characters stored
+ */
+int kkbd_drain(char *keys, int max);
+
+#endif
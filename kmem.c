@@ -0,0 +1,148 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Physical Page Frame Allocator
+ *
+ * Each page frame below KMEM_TOP has one bit in a bitmap; a set bit marks
+ * a free frame. SPEDE does not hand the kernel a memory map, so the frames
+ * from the end of the kernel image (including its bss) up to KMEM_TOP are
+ * treated as usable RAM. Runs of frames are found first-fit, skipping
+ * whole words of allocated frames at a time.
+ */
+#include "spede.h"
+#include "kernel.h"
+#include "kutil.h"
+#include "kmem.h"
+#include "string.h"
+
+// End of the kernel image, provided by the linker
+extern char end[];
+
+// Free frame bitmap
+unsigned int kmem_map[KMEM_MAP_WORDS];
+
+// First frame that may be free; nothing below it is ever free
+int kmem_first;
+
+int mem_pages_total;
+int mem_pages_free;
+int mem_alloc_fails;
+
+/**
+ * Checks whether a frame is free
+ * @param  frame - the frame number
+ * @return 1 if the frame is free; 0 otherwise
+ */
+int kmem_is_free(int frame) {
+    return (kmem_map[frame >> 5] >> (frame & 31)) & 1;
+}
+
+/**
+ * Initializes the allocator with every frame between the end of the
+ * kernel image and KMEM_TOP
+ */
+void kmem_init() {
+    int frame;
+
+    sp_memset(kmem_map, 0, sizeof(kmem_map));
+
+    kmem_first = PAGE_COUNT((unsigned int)end);
+    if (kmem_first >= KMEM_FRAMES) {
+        panic("Kernel image extends past KMEM_TOP");
+    }
+
+    for (frame = kmem_first; frame < KMEM_FRAMES; frame++) {
+        kmem_map[frame >> 5] |= 1U << (frame & 31);
+    }
+
+    mem_pages_total = KMEM_FRAMES - kmem_first;
+    mem_pages_free = mem_pages_total;
+    mem_alloc_fails = 0;
+}
+
+/**
+ * Allocates physically contiguous page frames
+ * @param  pages - number of frames
+ * @return address of the first frame; NULL if no run is large enough
+ */
+void *kmem_page_alloc(int pages) {
+    int frame;
+    int start;
+    int run;
+    unsigned int word;
+
+    if (pages <= 0 || pages > mem_pages_free) {
+        mem_alloc_fails++;
+        return NULL;
+    }
+
+    start = 0;
+    run = 0;
+    frame = kmem_first;
+
+    while (frame < KMEM_FRAMES) {
+        word = kmem_map[frame >> 5] >> (frame & 31);
+
+        if (word == 0) {
+            // Nothing free in the rest of this word
+            run = 0;
+            frame = (frame | 31) + 1;
+            continue;
+        }
+
+        if (run == 0) {
+            // Jump straight to the next free frame
+            frame += bit_first_set(word);
+            start = frame;
+        } else if (!(word & 1)) {
+            run = 0;
+            frame++;
+            continue;
+        }
+
+        run++;
+        frame++;
+
+        if (run == pages) {
+            for (frame = start; frame < start + pages; frame++) {
+                kmem_map[frame >> 5] &= ~(1U << (frame & 31));
+            }
+
+            mem_pages_free -= pages;
+            return (void *)(start << PAGE_SHIFT);
+        }
+    }
+
+    mem_alloc_fails++;
+    return NULL;
+}
+
+/**
+ * Returns page frames to the allocator
+ * @param addr  - address returned by kmem_page_alloc
+ * @param pages - number of frames that were allocated
+ */
+void kmem_page_free(void *addr, int pages) {
+    int start;
+    int frame;
+
+    start = (unsigned int)addr >> PAGE_SHIFT;
+
+    if (addr == NULL || ((unsigned int)addr & (PAGE_SIZE - 1)) != 0 ||
+        start < kmem_first || start + pages > KMEM_FRAMES) {
+        panic_warn("Invalid page frame address");
+        return;
+    }
+
+    for (frame = start; frame < start + pages; frame++) {
+        if (kmem_is_free(frame)) {
+            panic_warn("Page frame freed twice");
+            continue;
+        }
+
+        kmem_map[frame >> 5] |= 1U << (frame & 31);
+        mem_pages_free++;
+    }
+}
@@ -0,0 +1,54 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Physical Page Frame Allocator
+ */
+#ifndef KMEM_H
+#define KMEM_H
+
+// Page frame size
+#define PAGE_SHIFT 12
+#define PAGE_SIZE (1 << PAGE_SHIFT)
+
+// Rounds a byte count up to a whole number of pages
+#define PAGE_COUNT(bytes) (((bytes) + PAGE_SIZE - 1) >> PAGE_SHIFT)
+
+// Top of the physical memory managed by the allocator
+#ifndef KMEM_TOP
+#define KMEM_TOP 0x01000000
+#endif
+
+// Number of page frames below KMEM_TOP
+#define KMEM_FRAMES (KMEM_TOP >> PAGE_SHIFT)
+
+// Number of words in the free frame bitmap
+#define KMEM_MAP_WORDS ((KMEM_FRAMES + 31) / 32)
+
+// Page frame statistics
+extern int mem_pages_total;         // frames managed by the allocator
+extern int mem_pages_free;          // frames currently free
+extern int mem_alloc_fails;         // allocations that could not be satisfied
+
+/**
+ * Initializes the allocator with every frame between the end of the
+ * kernel image and KMEM_TOP
+ */
+void kmem_init();
+
+/**
+ * Allocates physically contiguous page frames
+ * @param  pages - number of frames
+ * @return address of the first frame; NULL if no run is large enough
+ */
+void *kmem_page_alloc(int pages);
+
+/**
+ * Returns page frames to the allocator
+ * @param addr  - address returned by kmem_page_alloc
+ * @param pages - number of frames that were allocated
+ */
+void kmem_page_free(void *addr, int pages);
+
+#endif
@@ -0,0 +1,661 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Paging and Process Address Spaces
+ *
+ * Physical memory below KMEM_TOP is identity mapped by a fixed set of
+ * page tables that every page directory shares, so the kernel, process
+ * stacks and page frames keep the same addresses in every address space.
+ * Each process has its own page directory; above the shared tables it
+ * maps a private heap that starts empty and is filled with zeroed pages
+ * as the process touches it, and a window at USER_STACK_TOP where its
+ * stack frames are mapped so a forked child finds its stack at the same
+ * address as the parent.
+ *
+ * Processes run in ring 0 without a separate fault stack, so a fault on
+ * a process stack would have nowhere to push its frame; stacks therefore
+ * stay fully allocated and only the heap is demand-zero.
+ *
+ * After a fork, heap pages are mapped read-only with PTE_COW in both
+ * processes and kpage_shares counts the extra mappings of each frame.
+ * The first write copies the page, unless no other mapping remains.
+ * CR0.WP makes ring 0 writes honor the read-only mappings. User processes
+ * are linked into the kernel image, whose data and bss the kernel itself
+ * writes through the shared identity map, so globals are not copied on a
+ * fork and stay shared between parent and child.
+ */
+#include "spede.h"
+#include "kernel.h"
+#include "kutil.h"
+#include "kmem.h"
+#include "kpage.h"
+#include "string.h"
+
+// Kernel page directory and the identity mapping tables
+unsigned int kpage_dir[PAGE_ENTRIES] __attribute__((aligned(PAGE_SIZE)));
+unsigned int kpage_tables[KPAGE_KERNEL_TABLES][PAGE_ENTRIES] __attribute__((aligned(PAGE_SIZE)));
+
+// Page directory currently loaded in CR3 and the process it belongs to
+unsigned int *kpage_space;
+int kpage_space_pid;
+
+int page_faults;
+int page_zero_fills;
+int page_cr3_loads;
+int page_cr3_skips;
+int page_forks;
+int page_fork_copies;
+int page_cow_copies;
+int page_loans;
+unsigned int page_fault_error;
+
+// Number of additional address spaces mapping each page frame
+unsigned short kpage_shares[KMEM_FRAMES];
+
+/**
+ * Loads a page directory into CR3
+ * @param dir - the page directory
+ * @param pid - process the directory belongs to; -1 for the kernel
+ */
+void kpage_load(unsigned int *dir, int pid) {
+    set_cr3((unsigned int)dir);
+    kpage_space = dir;
+    kpage_space_pid = pid;
+}
+
+/**
+ * Flushes the TLB entry of a virtual address
+ * @param addr - the virtual address
+ */
+void kpage_invalidate(unsigned int addr) {
+    asm volatile("invlpg (%0)" : : "r" (addr) : "memory");
+}
+
+/**
+ * Obtains the page table entry of a virtual address
+ * @param  dir      - the page directory
+ * @param  addr     - the virtual address
+ * @param  allocate - allocate the page table if it is missing
+ * @return pointer to the entry; NULL if there is no page table
+ */
+unsigned int *kpage_entry(unsigned int *dir, unsigned int addr, int allocate) {
+    unsigned int *table;
+
+    if (!(dir[PAGE_DIR_INDEX(addr)] & PTE_PRESENT)) {
+        if (!allocate) {
+            return NULL;
+        }
+
+        table = kmem_page_alloc(1);
+        if (table == NULL) {
+            return NULL;
+        }
+
+        sp_memset(table, 0, PAGE_SIZE);
+        dir[PAGE_DIR_INDEX(addr)] = (unsigned int)table | PTE_PRESENT | PTE_WRITE | PTE_USER;
+    }
+
+    table = (unsigned int *)(dir[PAGE_DIR_INDEX(addr)] & PTE_FRAME);
+
+    return &table[PAGE_TABLE_INDEX(addr)];
+}
+
+/**
+ * Drops one mapping of a heap page frame, freeing it with the last one
+ * @param frame - the page frame address
+ */
+void kpage_release(unsigned int frame) {
+    if (kpage_shares[frame >> PAGE_SHIFT] > 0) {
+        kpage_shares[frame >> PAGE_SHIFT]--;
+    } else {
+        kmem_page_free((void *)frame, 1);
+    }
+}
+
+/**
+ * Unmaps and frees the heap pages of a process in an address range
+ * @param pid   - the process id
+ * @param start - first address (page aligned)
+ * @param end   - end of the range (page aligned)
+ */
+void kpage_unmap(int pid, unsigned int start, unsigned int end) {
+    unsigned int addr;
+    unsigned int *pte;
+
+    for (addr = start; addr < end; addr += PAGE_SIZE) {
+        pte = kpage_entry(pcb[pid].page_dir, addr, 0);
+
+        if (pte != NULL && (*pte & PTE_PRESENT)) {
+            kpage_release(*pte & PTE_FRAME);
+            *pte = 0;
+
+            if (kpage_space == pcb[pid].page_dir) {
+                kpage_invalidate(addr);
+            }
+        }
+    }
+}
+
+/**
+ * Maps page frames owned by someone else into a process
+ * The frames are not freed when the process unmaps them or exits
+ * @param  pid   - the process id
+ * @param  va    - first virtual address (page aligned)
+ * @param  frame - first page frame address
+ * @param  pages - number of pages
+ * @return 0 on success; -1 if memory is exhausted
+ */
+int kpage_map(int pid, unsigned int va, unsigned int frame, int pages) {
+    unsigned int *pte;
+    int i;
+
+    for (i = 0; i < pages; i++) {
+        pte = kpage_entry(pcb[pid].page_dir, va + i * PAGE_SIZE, 1);
+        if (pte == NULL) {
+            kpage_unmap_shared(pid, va, i);
+            return -1;
+        }
+
+        *pte = (frame + i * PAGE_SIZE) | PTE_PRESENT | PTE_WRITE | PTE_USER;
+    }
+
+    return 0;
+}
+
+/**
+ * Removes mappings created with kpage_map
+ * @param pid   - the process id
+ * @param va    - first virtual address (page aligned)
+ * @param pages - number of pages
+ */
+void kpage_unmap_shared(int pid, unsigned int va, int pages) {
+    unsigned int *pte;
+    int i;
+
+    for (i = 0; i < pages; i++) {
+        pte = kpage_entry(pcb[pid].page_dir, va + i * PAGE_SIZE, 0);
+        if (pte == NULL) {
+            continue;
+        }
+
+        *pte = 0;
+
+        if (kpage_space == pcb[pid].page_dir) {
+            kpage_invalidate(va + i * PAGE_SIZE);
+        }
+    }
+}
+
+/**
+ * Builds the kernel identity mapping and enables paging
+ */
+void kpage_init() {
+    int i;
+    int j;
+
+    sp_memset(kpage_dir, 0, sizeof(kpage_dir));
+
+    for (i = 0; i < KPAGE_KERNEL_TABLES; i++) {
+        for (j = 0; j < PAGE_ENTRIES; j++) {
+            kpage_tables[i][j] = ((i * PAGE_ENTRIES + j) << PAGE_SHIFT) | PTE_PRESENT | PTE_WRITE;
+        }
+
+        kpage_dir[i] = (unsigned int)kpage_tables[i] | PTE_PRESENT | PTE_WRITE;
+    }
+
+    page_faults = 0;
+    page_zero_fills = 0;
+    page_cr3_loads = 0;
+    page_cr3_skips = 0;
+    page_forks = 0;
+    page_fork_copies = 0;
+    page_cow_copies = 0;
+    page_loans = 0;
+    sp_memset(kpage_shares, 0, sizeof(kpage_shares));
+
+    kpage_load(kpage_dir, -1);
+    set_cr0(get_cr0() | CR0_PG | CR0_WP);
+}
+
+/**
+ * Creates the address space of a process and maps its stack window
+ * @param  pid - the process id; its stack must already be allocated
+ * @return 0 on success; -1 if memory is exhausted
+ */
+int kpage_create(int pid) {
+    unsigned int *dir;
+    unsigned int *pte;
+    unsigned int va;
+    int i;
+
+    if (pcb[pid].stack_size > USER_STACK_MAX) {
+        return -1;
+    }
+
+    dir = kmem_page_alloc(1);
+    if (dir == NULL) {
+        return -1;
+    }
+
+    // Share the kernel tables; everything above them is private
+    sp_memcpy(dir, kpage_dir, KPAGE_KERNEL_TABLES * sizeof(unsigned int));
+    sp_memset(&dir[KPAGE_KERNEL_TABLES], 0, (PAGE_ENTRIES - KPAGE_KERNEL_TABLES) * sizeof(unsigned int));
+
+    pcb[pid].page_dir = dir;
+    pcb[pid].heap_brk = USER_HEAP_BASE;
+
+    // Map the stack frames just below the top of the stack window
+    va = USER_STACK_TOP - pcb[pid].stack_size;
+    for (i = 0; i < pcb[pid].stack_size; i += PAGE_SIZE) {
+        pte = kpage_entry(dir, va + i, 1);
+        if (pte == NULL) {
+            kpage_destroy(pid);
+            return -1;
+        }
+
+        *pte = (unsigned int)(pcb[pid].stack + i) | PTE_PRESENT | PTE_WRITE | PTE_USER;
+    }
+
+    pcb[pid].stack_va = (char *)va;
+
+    return 0;
+}
+
+/**
+ * Creates the address space of a child process from its parent's
+ * The heap is shared copy-on-write; the child's own stack is mapped in
+ * the stack window
+ * @param  ppid - the parent process id
+ * @param  pid  - the child process id; its stack must already be allocated
+ * @return number of page tables copied; -1 if memory is exhausted
+ */
+int kpage_fork(int ppid, int pid) {
+    unsigned int *parent_dir;
+    unsigned int *parent_table;
+    unsigned int *table;
+    int copied;
+    int i;
+    int j;
+
+    if (kpage_create(pid) != 0) {
+        return -1;
+    }
+
+    parent_dir = pcb[ppid].page_dir;
+    pcb[pid].heap_brk = pcb[ppid].heap_brk;
+    copied = 0;
+
+    for (i = PAGE_DIR_INDEX(USER_HEAP_BASE); i < PAGE_DIR_INDEX(USER_HEAP_BASE + USER_HEAP_MAX); i++) {
+        if (!(parent_dir[i] & PTE_PRESENT)) {
+            continue;
+        }
+
+        table = kmem_page_alloc(1);
+        if (table == NULL) {
+            kpage_destroy(pid);
+            return -1;
+        }
+
+        // Both processes map every page read-only until one writes to it
+        parent_table = (unsigned int *)(parent_dir[i] & PTE_FRAME);
+        for (j = 0; j < PAGE_ENTRIES; j++) {
+            if (parent_table[j] & PTE_PRESENT) {
+                parent_table[j] = (parent_table[j] & ~PTE_WRITE) | PTE_COW;
+                kpage_shares[parent_table[j] >> PAGE_SHIFT]++;
+            }
+            table[j] = parent_table[j];
+        }
+
+        pcb[pid].page_dir[i] = (unsigned int)table | PTE_PRESENT | PTE_WRITE | PTE_USER;
+        copied++;
+    }
+
+    // Flush the parent's now stale writable translations
+    if (kpage_space == parent_dir) {
+        kpage_load(parent_dir, ppid);
+    }
+
+    page_forks++;
+    page_fork_copies += copied;
+
+    return copied;
+}
+
+/**
+ * Frees the address space of a process along with every page mapped in it
+ * @param pid - the process id
+ */
+void kpage_destroy(int pid) {
+    unsigned int *dir;
+    int i;
+
+    dir = pcb[pid].page_dir;
+    if (dir == NULL) {
+        return;
+    }
+
+    // Never free the directory out from under the CPU
+    if (kpage_space == dir) {
+        kpage_load(kpage_dir, -1);
+    }
+
+    // Nothing is ever mapped above the heap break
+    kpage_unmap(pid, USER_HEAP_BASE, (pcb[pid].heap_brk + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1));
+
+    for (i = KPAGE_KERNEL_TABLES; i < PAGE_ENTRIES; i++) {
+        if (dir[i] & PTE_PRESENT) {
+            kmem_page_free((void *)(dir[i] & PTE_FRAME), 1);
+        }
+    }
+
+    kmem_page_free(dir, 1);
+    pcb[pid].page_dir = NULL;
+    pcb[pid].heap_brk = 0;
+}
+
+/**
+ * Loads the address space of a process
+ * @param pid - the process id
+ */
+void kpage_switch(int pid) {
+    unsigned int *dir;
+
+    dir = pcb[pid].page_dir;
+
+#if PAGE_LAZY_CR3
+    // The idle task never touches process memory
+    if (pid == 0 || dir == kpage_space) {
+        page_cr3_skips++;
+        return;
+    }
+#endif
+
+    if (dir == NULL) {
+        dir = kpage_dir;
+    }
+
+    kpage_load(dir, dir == kpage_dir ? -1 : pid);
+    page_cr3_loads++;
+}
+
+/**
+ * Gives a process a private, writable copy of a copy-on-write page
+ * @param  pid  - the process id
+ * @param  addr - faulting virtual address
+ * @return 0 if the page is now writable; -1 if the access is invalid
+ */
+int kpage_copy_on_write(int pid, unsigned int addr) {
+    unsigned int *pte;
+    unsigned int frame;
+    void *copy;
+
+    pte = kpage_entry(pcb[pid].page_dir, addr, 0);
+    if (pte == NULL || !(*pte & PTE_COW)) {
+        return -1;
+    }
+
+    frame = *pte & PTE_FRAME;
+
+    if (kpage_shares[frame >> PAGE_SHIFT] == 0) {
+        // Every other mapping is gone; take the page back as is
+        *pte = (*pte & ~PTE_COW) | PTE_WRITE;
+    } else {
+        copy = kmem_page_alloc(1);
+        if (copy == NULL) {
+            return -1;
+        }
+
+        sp_memcpy(copy, (void *)frame, PAGE_SIZE);
+        kpage_shares[frame >> PAGE_SHIFT]--;
+        *pte = (unsigned int)copy | PTE_PRESENT | PTE_WRITE | PTE_USER;
+        page_cow_copies++;
+    }
+
+    kpage_invalidate(addr);
+
+    return 0;
+}
+
+/**
+ * Maps a zeroed page at a heap address that has no page yet
+ * @param  pid  - the process id
+ * @param  addr - the virtual address
+ * @return 0 if the page was mapped; -1 if memory is exhausted
+ */
+int kpage_zero_fill(int pid, unsigned int addr) {
+    unsigned int *pte;
+    void *frame;
+
+    pte = kpage_entry(pcb[pid].page_dir, addr, 1);
+    if (pte == NULL) {
+        return -1;
+    }
+
+    frame = kmem_page_alloc(1);
+    if (frame == NULL) {
+        return -1;
+    }
+
+    // Frames are identity mapped, so the page can be cleared before mapping
+    sp_memset(frame, 0, PAGE_SIZE);
+    *pte = (unsigned int)frame | PTE_PRESENT | PTE_WRITE | PTE_USER;
+    page_zero_fills++;
+
+    return 0;
+}
+
+/**
+ * Resolves a page fault by mapping a demand-zero page or copying a
+ * copy-on-write page
+ * @param  pid   - process whose address space faulted
+ * @param  addr  - faulting virtual address
+ * @param  error - page fault error code
+ * @return 0 if the page was mapped; -1 if the access is invalid
+ */
+int kpage_fault(int pid, unsigned int addr, unsigned int error) {
+    page_faults++;
+
+    if (pid < 0 || pid > PID_MAX || pcb[pid].page_dir == NULL) {
+        return -1;
+    }
+
+    // Writes to a shared page get a private copy
+    if (error & PF_PRESENT) {
+        return (error & PF_WRITE) ? kpage_copy_on_write(pid, addr) : -1;
+    }
+
+    // Only missing pages below the heap break are demand-zero
+    if (addr < USER_HEAP_BASE || addr >= pcb[pid].heap_brk) {
+        return -1;
+    }
+
+    return kpage_zero_fill(pid, addr);
+}
+
+/**
+ * Resolves a page fault taken while the kernel was running
+ * Called on the kernel stack from the page fault entry; panics if the
+ * fault cannot be resolved
+ */
+void kpage_fault_kernel() {
+    // The kernel only touches process memory through the loaded space
+    if (kpage_fault(kpage_space_pid, get_cr2(), page_fault_error) != 0) {
+        panic("Kernel page fault");
+    }
+}
+
+/**
+ * Moves the heap break of a process
+ * @param  pid       - the process id
+ * @param  increment - bytes to grow (or shrink if negative) the heap
+ * @return the previous break; 0 if the heap cannot be resized
+ */
+unsigned int kpage_sbrk(int pid, int increment) {
+    unsigned int old_brk;
+    unsigned int new_brk;
+
+    if (pcb[pid].page_dir == NULL) {
+        return 0;
+    }
+
+    old_brk = pcb[pid].heap_brk;
+    new_brk = old_brk + increment;
+
+    if (new_brk < USER_HEAP_BASE || new_brk > USER_HEAP_BASE + USER_HEAP_MAX) {
+        return 0;
+    }
+
+    // Pages are only mapped when touched, but released pages go right away
+    if (new_brk < old_brk) {
+        kpage_unmap(pid, (new_brk + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1), old_brk);
+    }
+
+    pcb[pid].heap_brk = new_brk;
+
+    return old_brk;
+}
+
+/**
+ * Takes heap pages away from a process so they can be handed to another
+ * Every page is first made present and private to the process, so the
+ * frames can be given away without copying; the range is left unmapped
+ * and reads as zero if the process touches it again
+ * @param  pid    - the process id
+ * @param  addr   - first virtual address (page aligned)
+ * @param  pages  - number of pages
+ * @param  frames - receives the page frame addresses
+ * @return 0 on success; -1 if the range is invalid or memory is exhausted
+ */
+int kpage_loan(int pid, unsigned int addr, int pages, unsigned int *frames) {
+    unsigned int *pte;
+    unsigned int va;
+    int i;
+
+    if (pcb[pid].page_dir == NULL || pages <= 0 || (addr & (PAGE_SIZE - 1)) != 0 ||
+        addr < USER_HEAP_BASE || addr + pages * PAGE_SIZE > pcb[pid].heap_brk) {
+        return -1;
+    }
+
+    // Nothing is taken until every page is known to be loanable
+    for (i = 0, va = addr; i < pages; i++, va += PAGE_SIZE) {
+        pte = kpage_entry(pcb[pid].page_dir, va, 0);
+
+        if (pte == NULL || !(*pte & PTE_PRESENT)) {
+            if (kpage_zero_fill(pid, va) != 0) {
+                return -1;
+            }
+        } else if (*pte & PTE_COW) {
+            if (kpage_copy_on_write(pid, va) != 0) {
+                return -1;
+            }
+        }
+    }
+
+    for (i = 0, va = addr; i < pages; i++, va += PAGE_SIZE) {
+        pte = kpage_entry(pcb[pid].page_dir, va, 0);
+        frames[i] = *pte & PTE_FRAME;
+        *pte = 0;
+
+        if (kpage_space == pcb[pid].page_dir) {
+            kpage_invalidate(va);
+        }
+    }
+
+    page_loans += pages;
+
+    return 0;
+}
+
+/**
+ * Maps loaned page frames at the end of a process' heap
+ * The heap break is moved past the new pages
+ * @param  pid    - the process id
+ * @param  frames - the page frame addresses
+ * @param  pages  - number of pages
+ * @return the address of the first page; 0 if the heap cannot hold them
+ */
+unsigned int kpage_adopt(int pid, unsigned int *frames, int pages) {
+    unsigned int *pte;
+    unsigned int addr;
+    int i;
+
+    if (pcb[pid].page_dir == NULL) {
+        return 0;
+    }
+
+    addr = (pcb[pid].heap_brk + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    if (addr + pages * PAGE_SIZE > USER_HEAP_BASE + USER_HEAP_MAX) {
+        return 0;
+    }
+
+    for (i = 0; i < pages; i++) {
+        pte = kpage_entry(pcb[pid].page_dir, addr + i * PAGE_SIZE, 1);
+        if (pte == NULL) {
+            // Leave the frames with the caller
+            kpage_unmap_shared(pid, addr, i);
+            return 0;
+        }
+
+        *pte = frames[i] | PTE_PRESENT | PTE_WRITE | PTE_USER;
+    }
+
+    pcb[pid].heap_brk = addr + pages * PAGE_SIZE;
+
+    return addr;
+}
+
+/**
+ * Copies memory into the address space of another process
+ * Page frames are identity mapped, so each destination page is looked up
+ * in the process' page tables and written through its frame without
+ * switching address spaces. Heap pages are made present and private first;
+ * the copy stops at the first address that cannot be written
+ * @param pid - destination process id
+ * @param dst - destination address in the process' address space
+ * @param src - source address in the current address space
+ * @param len - number of bytes
+ */
+void kpage_copy_to(int pid, void *dst, void *src, int len) {
+    unsigned int addr;
+    unsigned int offset;
+    unsigned int *pte;
+    int n;
+
+    if (pcb[pid].page_dir == NULL || pcb[pid].page_dir == kpage_space) {
+        sp_memcpy(dst, src, len);
+        return;
+    }
+
+    addr = (unsigned int)dst;
+
+    while (len > 0) {
+        offset = addr & (PAGE_SIZE - 1);
+        n = PAGE_SIZE - offset;
+        if (n > len) {
+            n = len;
+        }
+
+        pte = kpage_entry(pcb[pid].page_dir, addr, 0);
+
+        // Resolve what a write from the process itself would fault on
+        if (pte == NULL || !(*pte & PTE_PRESENT)) {
+            if (addr < USER_HEAP_BASE || addr >= pcb[pid].heap_brk ||
+                kpage_zero_fill(pid, addr) != 0) {
+                return;
+            }
+            pte = kpage_entry(pcb[pid].page_dir, addr, 0);
+        } else if (!(*pte & PTE_WRITE)) {
+            if (kpage_copy_on_write(pid, addr) != 0) {
+                return;
+            }
+        }
+
+        sp_memcpy((void *)((*pte & PTE_FRAME) + offset), src, n);
+
+        addr += n;
+        src = (char *)src + n;
+        len -= n;
+    }
+}
@@ -0,0 +1,195 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Paging and Process Address Spaces
+ */
+#ifndef KPAGE_H
+#define KPAGE_H
+
+#include "kmem.h"
+
+// Page directory and page table entry flags
+#define PTE_PRESENT 0x001               // page is mapped
+#define PTE_WRITE 0x002                 // page is writable
+#define PTE_USER 0x004                  // page is accessible outside ring 0
+#define PTE_COW 0x200                   // read-only page shared copy-on-write
+
+// Mask of the frame address in a page directory or page table entry
+#define PTE_FRAME 0xFFFFF000
+
+// Entries in a page directory or page table
+#define PAGE_ENTRIES 1024
+
+// Page directory and page table indices of a virtual address
+#define PAGE_DIR_INDEX(va) ((unsigned int)(va) >> 22)
+#define PAGE_TABLE_INDEX(va) (((unsigned int)(va) >> PAGE_SHIFT) & (PAGE_ENTRIES - 1))
+
+// Page fault error code bits
+#define PF_PRESENT 0x1                  // fault on a present page (protection)
+#define PF_WRITE 0x2                    // fault caused by a write
+
+// Control register 0 bits
+#ifndef CR0_PG
+#define CR0_PG 0x80000000               // paging enable
+#endif
+#ifndef CR0_WP
+#define CR0_WP 0x00010000               // ring 0 honors read-only pages
+#endif
+
+// Page tables identity mapping physical memory, shared by every address space
+#define KPAGE_KERNEL_TABLES (KMEM_TOP >> 22)
+
+// Per-process demand-zero heap region
+#define USER_HEAP_BASE 0x40000000
+#define USER_HEAP_MAX 0x10000000
+
+// Per-process stack window; the stack frames are mapped just below the top
+#define USER_STACK_TOP 0x80000000
+#define USER_STACK_MAX 0x00400000
+
+// Per-process shared memory region; each segment has a fixed slot
+#define USER_SHM_BASE 0x60000000
+
+// Converts an address on a process stack between the process' view and
+// the kernel's identity mapped alias of the stack frames
+#define KPAGE_STACK_KVA(pid, va) ((void *)(pcb[pid].stack + ((char *)(va) - pcb[pid].stack_va)))
+#define KPAGE_STACK_UVA(pid, ka) ((void *)(pcb[pid].stack_va + ((char *)(ka) - pcb[pid].stack)))
+
+// Only reload CR3 when switching to a different address space; the idle
+// task borrows whichever address space is loaded
+#ifndef PAGE_LAZY_CR3
+#define PAGE_LAZY_CR3 1
+#endif
+
+// Paging statistics
+extern int page_faults;                 // page faults taken
+extern int page_zero_fills;             // demand-zero pages mapped
+extern int page_cr3_loads;              // address space switches
+extern int page_cr3_skips;              // switches avoided by lazy CR3
+extern int page_forks;                  // address spaces duplicated
+extern int page_fork_copies;            // pages copied while duplicating
+extern int page_cow_copies;             // pages copied on a write after a fork
+extern int page_loans;                  // pages moved between processes
+
+// Error code pushed by the CPU for the most recent page fault
+extern unsigned int page_fault_error;
+
+/**
+ * Builds the kernel identity mapping and enables paging
+ */
+void kpage_init();
+
+/**
+ * Creates the address space of a process and maps its stack window
+ * @param  pid - the process id; its stack must already be allocated
+ * @return 0 on success; -1 if memory is exhausted
+ */
+int kpage_create(int pid);
+
+/**
+ * Creates the address space of a child process from its parent's
+ * The heap is shared copy-on-write; the child's own stack is mapped in
+ * the stack window
+ * Only the heap is copy-on-write: the kernel image, including the data
+ * and bss of user processes (globals such as semaphore ids and mailbox
+ * numbers), lies in the identity map every process shares, so parent and
+ * child keep reading and writing the same globals
+ * @param  ppid - the parent process id
+ * @param  pid  - the child process id; its stack must already be allocated
+ * @return number of page tables copied; -1 if memory is exhausted
+ */
+int kpage_fork(int ppid, int pid);
+
+/**
+ * Frees the address space of a process along with every page mapped in it
+ * @param pid - the process id
+ */
+void kpage_destroy(int pid);
+
+/**
+ * Maps page frames owned by someone else into a process
+ * The frames are not freed when the process unmaps them or exits
+ * @param  pid   - the process id
+ * @param  va    - first virtual address (page aligned)
+ * @param  frame - first page frame address
+ * @param  pages - number of pages
+ * @return 0 on success; -1 if memory is exhausted
+ */
+int kpage_map(int pid, unsigned int va, unsigned int frame, int pages);
+
+/**
+ * Removes mappings created with kpage_map
+ * @param pid   - the process id
+ * @param va    - first virtual address (page aligned)
+ * @param pages - number of pages
+ */
+void kpage_unmap_shared(int pid, unsigned int va, int pages);
+
+/**
+ * Loads the address space of a process
+ * @param pid - the process id
+ */
+void kpage_switch(int pid);
+
+/**
+ * Resolves a page fault by mapping a demand-zero page or copying a
+ * copy-on-write page
+ * @param  pid   - process whose address space faulted
+ * @param  addr  - faulting virtual address
+ * @param  error - page fault error code
+ * @return 0 if the page was mapped; -1 if the access is invalid
+ */
+int kpage_fault(int pid, unsigned int addr, unsigned int error);
+
+/**
+ * Resolves a page fault taken while the kernel was running
+ * Called on the kernel stack from the page fault entry; panics if the
+ * fault cannot be resolved
+ */
+void kpage_fault_kernel();
+
+/**
+ * Moves the heap break of a process
+ * @param  pid       - the process id
+ * @param  increment - bytes to grow (or shrink if negative) the heap
+ * @return the previous break; 0 if the heap cannot be resized
+ */
+unsigned int kpage_sbrk(int pid, int increment);
+
+/**
+ * Takes heap pages away from a process so they can be handed to another
+ * Every page is first made present and private to the process, so the
+ * frames can be given away without copying; the range is left unmapped
+ * and reads as zero if the process touches it again
+ * @param  pid    - the process id
+ * @param  addr   - first virtual address (page aligned)
+ * @param  pages  - number of pages
+ * @param  frames - receives the page frame addresses
+ * @return 0 on success; -1 if the range is invalid or memory is exhausted
+ */
+int kpage_loan(int pid, unsigned int addr, int pages, unsigned int *frames);
+
+/**
+ * Maps loaned page frames at the end of a process' heap
+ * The heap break is moved past the new pages
+ * @param  pid    - the process id
+ * @param  frames - the page frame addresses
+ * @param  pages  - number of pages
+ * @return the address of the first page; 0 if the heap cannot hold them
+ */
+unsigned int kpage_adopt(int pid, unsigned int *frames, int pages);
+
+/**
+ * Copies memory into the address space of another process
+ * The destination pages are written through their frames, without
+ * switching address spaces
+ * @param pid - destination process id
+ * @param dst - destination address in the process' address space
+ * @param src - source address in the current address space
+ * @param len - number of bytes
+ */
+void kpage_copy_to(int pid, void *dst, void *src, int len);
+
+#endif
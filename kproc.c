@@ -10,108 +10,423 @@
 #include "kutil.h"
 #include "kproc.h"
 #include "queue.h"
+#include "ktimer.h"
+#include "kfair.h"
+#include "ksched.h"
+#include "kedf.h"
+#include "kmem.h"
+#include "kpage.h"
+#include "kshm.h"
+#include "ksyscall.h"
 #include "string.h"
 
+// Process that was last loaded by the scheduler, -1 if none
+int sched_last_pid = -1;
+
+// Context switch statistics
+int sched_switches_voluntary;
+int sched_switches_involuntary;
+
+// Idle statistics
+int idle_ticks;
+int idle_halts;
+
 /**
- * Process scheduler
+ * Makes a process runnable by handing it to the scheduler policy
+ * The kernel idle task (PID 0) is placed on the idle queue instead, and
+ * EDF class processes are handled ahead of the scheduler policy
+ * @param pid - the process to queue
  */
-void kproc_schedule() {
-	
-    // Once the active process has exceeded the maximum
-    // number of ticks, it needs to be unscheduled:
-    // reset the current active time
-    int wakeup_pid;
-    int sleep_pid;
+void kproc_enqueue(int pid) {
+    pcb[pid].state = RUNNING;
+
+    if (pid == 0) {
+        plist_in(&idle_q, pid);
+        return;
+    }
 
-    while(sleep_q.size != 0){
+    if (pcb[pid].sched_class == SCHED_EDF) {
+        kedf_enqueue(pid);
+        return;
+    }
 
-        sleep_pid = sleep_q.items[sleep_q.head];
-        wakeup_pid = pcb[sleep_pid].wake_time;
+    sched_nr_running++;
+    sched_ops->enqueue(pid);
+}
 
-        if(wakeup_pid <= system_time){
+/**
+ * Returns the preempted active process to the scheduler policy
+ * @param pid - the process to queue
+ */
+void kproc_requeue(int pid) {
+    pcb[pid].state = RUNNING;
 
-            pcb[sleep_pid].state = RUNNING;
-            queue_out(&sleep_q, &sleep_pid);
-            
-            if(sleep_pid == 0){
+    if (pid == 0) {
+        plist_in(&idle_q, pid);
+        return;
+    }
 
-                pcb[sleep_pid].queue = &idle_q;
-                queue_in(&idle_q, sleep_pid);
-            }
-            else{
-                
-                pcb[sleep_pid].queue = &run_q;
-                queue_in(&run_q, sleep_pid);
-            }
-        }
-        else{
-            break;
-        }
+    if (pcb[pid].sched_class == SCHED_EDF) {
+        kedf_yield(pid);
+        return;
     }
 
-    if(active_pid > -1){
-    //   reset the current active time
-        pcb[active_pid].active_time = 0;
-    //   set the state to RUNNING
-        pcb[active_pid].state = RUNNING; 
-    //   queue the process back into the running queue
-        if(active_pid == 0){
-            pcb[active_pid].queue = &idle_q;
-            queue_in(&idle_q, active_pid); 
-        }else{
-            pcb[active_pid].queue = &run_q;
-            queue_in(&run_q, active_pid);
-        }
-    //   clear the active pid
-        active_pid = -1;
+    sched_nr_running++;
+    sched_ops->yield(pid);
+}
+
+/**
+ * Removes a runnable process from the run queue it is waiting on
+ * @param pid - the process id; must be in the RUNNING state
+ */
+void kproc_unqueue(int pid) {
+    if (pid == 0) {
+        return;
+    }
 
+    if (pcb[pid].sched_class == SCHED_EDF) {
+        kedf_remove(pid);
+        return;
     }
 
-    // if we don't have an actively running process:
-    if (active_pid == -1) {
-        if(run_q.size == 0){
-            //queue_out the process from the running queue and set it to the active pid
-            queue_out(&idle_q, &active_pid);
-        }else{
-            //queue_out the process from the running queue and set it to the active pid
-            queue_out(&run_q, &active_pid);
-        }
-        if(active_pid >= 0 && active_pid <= PID_MAX) {
-        //   set the state in the process control block for the new active proces to ACTIVE
-            pcb[active_pid].state = ACTIVE;
+    sched_nr_running--;
+    sched_ops->dequeue(pid);
+}
+
+/**
+ * Removes the next process to run as chosen by the scheduler policy
+ * Falls back to the idle queue when no other process is runnable
+ * @return the process id; -1 if nothing could be dequeued
+ */
+int kproc_dequeue() {
+    int pid = -1;
+
+    // EDF class processes run ahead of everything else
+    if (edf_q_size > 0) {
+        return kedf_pick_next();
+    }
+
+    if (sched_nr_running > 0) {
+        pid = sched_ops->pick_next();
+        if (pid >= 0) {
+            sched_nr_running--;
+            return pid;
         }
     }
 
+    plist_out(&idle_q, &pid);
+
+    return pid;
+}
+
+/**
+ * Changes the scheduling priority of a process
+ * The process is moved into the priority class, and if it is waiting on a
+ * run queue it is moved to its new level
+ * @param pid  - the process id
+ * @param prio - the new priority (0 is highest)
+ * @return -1 on error; 0 on success
+ */
+int kproc_set_priority(int pid, int prio) {
+    if (pid < 0 || pid > PID_MAX || prio < 0 || prio >= PRIO_LEVELS) {
+        return -1;
+    }
+
+    if (pcb[pid].state == AVAILABLE) {
+        return -1;
+    }
+
+    // A waiting process takes its new priority the next time it is queued
+    if (pcb[pid].state == RUNNING) {
+        kproc_unqueue(pid);
+    }
+
+    kedf_release(pid);
+    pcb[pid].sched_class = SCHED_PRIO;
+    pcb[pid].base_priority = prio;
+
+    // Keep any priority inherited through semaphores the process holds
+    pcb[pid].priority = ksem_priority(pid);
+
+    if (pcb[pid].state == RUNNING) {
+        kproc_enqueue(pid);
+    }
+
+    return 0;
+}
+
+/**
+ * Changes the effective priority of a process without changing its base
+ * priority, as done by priority inheritance
+ * @param pid  - the process id
+ * @param prio - the effective priority (0 is highest)
+ */
+void kproc_boost_priority(int pid, int prio) {
+    if (pcb[pid].state == RUNNING) {
+        kproc_unqueue(pid);
+        pcb[pid].priority = prio;
+        kproc_enqueue(pid);
+    } else {
+        pcb[pid].priority = prio;
+    }
+}
+
+/**
+ * Changes the nice value of a process
+ * The process is moved into the fair class, where its share of the CPU
+ * is proportional to the weight of its nice value
+ * @param pid  - the process id
+ * @param nice - the nice value, NICE_MIN (largest share) to NICE_MAX
+ * @return -1 on error; 0 on success
+ */
+int kproc_set_nice(int pid, int nice) {
+    if (pid <= 0 || pid > PID_MAX || nice < NICE_MIN || nice > NICE_MAX) {
+        return -1;
+    }
+
+    if (pcb[pid].state == AVAILABLE) {
+        return -1;
+    }
+
+    if (pcb[pid].state == RUNNING) {
+        kproc_unqueue(pid);
+    }
+
+    kedf_release(pid);
+    pcb[pid].sched_class = SCHED_FAIR;
+    pcb[pid].nice = nice;
+    pcb[pid].weight = kfair_weight(nice);
+
+    if (pcb[pid].state == RUNNING) {
+        kproc_enqueue(pid);
+    }
+
+    return 0;
+}
+
+/**
+ * Moves a process into the EDF class with the specified reservation
+ * A runtime of 0 returns the process to the priority class
+ * @param pid      - the process id
+ * @param period   - activation period in ticks
+ * @param runtime  - CPU budget per period in ticks
+ * @param deadline - deadline relative to the start of each period in ticks
+ * @return -1 on error or if admission control rejects the reservation;
+ *         0 on success
+ */
+int kproc_set_deadline(int pid, int period, int runtime, int deadline) {
+    int rc;
+
+    if (pid <= 0 || pid > PID_MAX || pcb[pid].state == AVAILABLE) {
+        return -1;
+    }
+
+    if (pcb[pid].state == RUNNING) {
+        kproc_unqueue(pid);
+    }
+
+    if (runtime == 0) {
+        kedf_release(pid);
+        pcb[pid].sched_class = SCHED_PRIO;
+        rc = 0;
+    } else {
+        rc = kedf_admit(pid, period, runtime, deadline);
+    }
+
+    if (pcb[pid].state == RUNNING) {
+        kproc_enqueue(pid);
+    }
+
+    return rc;
+}
+
+/**
+ * Changes the time slice of a process
+ * @param pid   - the process id
+ * @param ticks - number of ticks the process may run before being preempted
+ * @return -1 on error; 0 on success
+ */
+int kproc_set_quantum(int pid, int ticks) {
+    if (pid < 0 || pid > PID_MAX || ticks <= 0) {
+        return -1;
+    }
+
+    if (pcb[pid].state == AVAILABLE) {
+        return -1;
+    }
+
+    pcb[pid].quantum = ticks;
+
+    return 0;
+}
+
+/**
+ * Determines if the active process must give up the CPU
+ * @param pid - the active process id
+ * @return 1 if the process should be preempted; 0 otherwise
+ */
+int kproc_preempt(int pid) {
+    // Blocked processes are no longer active
+    if (pcb[pid].state != ACTIVE) {
+        return 1;
+    }
+
+    // The idle task only runs when nothing else can
+    if (pid == 0) {
+        return sched_nr_running > 0 || edf_q_size > 0;
+    }
+
+    // EDF class processes run until their budget is used up or an
+    // earlier deadline arrives
+    if (pcb[pid].sched_class == SCHED_EDF) {
+        return kedf_check_preempt(pid);
+    }
+
+    // Any runnable EDF class process preempts the scheduler policy
+    if (edf_q_size > 0) {
+        return 1;
+    }
+
+    // Time slice has expired
+    if (pcb[pid].active_time >= pcb[pid].quantum) {
+        return 1;
+    }
+
+    // Let the scheduler policy decide if another process should run
+    return sched_ops->check_preempt(pid);
+}
+
+/**
+ * Process scheduler
+ */
+void kproc_schedule() {
+    // Sleeping processes are woken by the timer ISR (see ktimer_tick)
+
+    // Keep running the active process until it blocks or is preempted
+    if(active_pid > -1 && kproc_preempt(active_pid)){
+        // queue the process back into its run queue
+        kproc_requeue(active_pid);
+
+        // clear the active pid
+        active_pid = -1;
+    }
+
+    if(active_pid == -1){
+        // Select the highest priority runnable process
+        active_pid = kproc_dequeue();
+
+        // Account for the context switch
+        if(active_pid != sched_last_pid && sched_last_pid > -1 && active_pid > -1){
+            if(pcb[sched_last_pid].state == RUNNING){
+                pcb[sched_last_pid].switches_involuntary++;
+                sched_switches_involuntary++;
+            }else{
+                pcb[sched_last_pid].switches_voluntary++;
+                sched_switches_voluntary++;
+            }
+        }
+        sched_last_pid = active_pid;
+    }
 
     // if we do not have a valid pid, we should panic
     if(active_pid < 0 || active_pid > PID_MAX){
         panic("PANIC: DO NOT HAVE A VALID PID\n");
     }
 
-    // Load the next process
-    kproc_load(pcb[active_pid].trapframe_p);
+    // set the state in the process control block for the new active process to ACTIVE
+    if(pcb[active_pid].state != ACTIVE){
+        pcb[active_pid].state = ACTIVE;
+
+        // and start a new time slice
+        pcb[active_pid].active_time = 0;
+    }
+
+    // Stop the periodic tick while only the idle task can run
+    if(active_pid == 0){
+        ktimer_idle_enter();
+    }
+
+    // Load the next process in its own address space
+    kpage_switch(active_pid);
+    kproc_load(KPAGE_STACK_UVA(active_pid, pcb[active_pid].trapframe_p));
 }
 
 /**
- * Start a new process
+ * Checks that a process has not overrun the bottom of its stack
+ * @param  pid - the process id
+ * @return 0 if the stack canary is intact; -1 otherwise
+ */
+int kproc_stack_check(int pid) {
+    if (pcb[pid].stack == NULL) {
+        return 0;
+    }
+
+    return *(unsigned int *)pcb[pid].stack == PROC_STACK_CANARY ? 0 : -1;
+}
+
+/**
+ * Measures the most stack a process has used so far
+ * Requires PROC_STACK_WATERMARK so untouched stack can be recognized
+ * @param  pid - the process id
+ * @return the high-water mark in bytes; -1 if it cannot be measured
+ */
+int kproc_stack_used(int pid) {
+    int i;
+
+    if (!PROC_STACK_WATERMARK || pcb[pid].stack == NULL) {
+        return -1;
+    }
+
+    // Skip the canary and find the lowest byte that has been written
+    for (i = sizeof(unsigned int); i < pcb[pid].stack_size; i++) {
+        if ((unsigned char)pcb[pid].stack[i] != PROC_STACK_FILL) {
+            break;
+        }
+    }
+
+    return pcb[pid].stack_size - i;
+}
+
+/**
+ * Start a new process with the default stack size
  * @param proc_name The process title
  * @param proc_ptr  function pointer for the process
- * @param queue     the run queue in which this process belongs
+ * @param queue     the run queue in which this process belongs; passing
+ *                  one of run_q[] sets the initial process priority
  */
-void kproc_exec(char *proc_name, void *proc_ptr, queue_t *queue) {
-    int pid; 
-    int i=0;
+void kproc_exec(char *proc_name, void *proc_ptr, plist_t *queue) {
+    kproc_exec_stack(proc_name, proc_ptr, queue, PROC_STACK_SIZE);
+}
 
-    // Ensure that valid parameters have been specified and panic otherwise
-	if(!proc_name||!proc_ptr||!queue){
-    	panic("Prameters not specified\n");
-	} 
-	pid = (int)proc_ptr;
+/**
+ * Allocates a process id and runtime stack and resets the PCB entry
+ * The process is not given an address space or a trapframe
+ * @param  proc_name  The process title
+ * @param  stack_size runtime stack size in bytes; rounded up to whole pages
+ * @return the process id; -1 if no process or memory is available
+ */
+int kproc_alloc(char *proc_name, int stack_size) {
+    int pid;
+    char *stack;
+
+    // The stack must at least hold the initial trapframe
+    if (stack_size < (int)sizeof(trapframe_t)) {
+        stack_size = sizeof(trapframe_t);
+    }
+    stack_size = PAGE_COUNT(stack_size) * PAGE_SIZE;
+
+    // Take the stack from the page frame allocator
+    stack = kmem_page_alloc(stack_size / PAGE_SIZE);
+    if (stack == NULL) {
+        panic_warn("Unable to allocate process stack\n");
+        return -1;
+    }
 
     // Dequeue the process from the available queue
     if (queue_out(&available_q, &pid) != 0) {
+        kmem_page_free(stack, stack_size / PAGE_SIZE);
         panic_warn("Unable to retrieve process from unused queue\n");
-        return;
+        return -1;
     }
 
     // Initialize the PCB entry for the process (e.g. pcb[pid])
@@ -122,17 +437,89 @@ void kproc_exec(char *proc_name, void *proc_ptr, queue_t *queue) {
     // Initialize other process control block variables to default values
     pcb[pid].active_time = 0; //default value set to 0 for active
     pcb[pid].total_time = 0; //default value set to 0 for total_time
+    pcb[pid].quantum = PROC_TICKS_MAX;
+    pcb[pid].sched_class = SCHED_PRIO;
+    pcb[pid].priority = PRIO_DEFAULT;
+    pcb[pid].base_priority = PRIO_DEFAULT;
+    pcb[pid].blocked_on = -1;
+    pcb[pid].nice = 0;
+    pcb[pid].weight = NICE_0_WEIGHT;
+    pcb[pid].vruntime = 0;
+    pcb[pid].fair_index = -1;
+    pcb[pid].pass = 0;
+    pcb[pid].dl_overruns = 0;
+    pcb[pid].dl_misses = 0;
+    pcb[pid].switches_voluntary = 0;
+    pcb[pid].switches_involuntary = 0;
     // Copy the process name to the PCB
     sp_strcpy(pcb[pid].name, proc_name);
-    
-    // Ensure the stack for the process is cleared (e.g. stack[pid])
-    while(i<PROC_STACK_SIZE){
-        stack[pid][i]=-1;
-        i++;
+
+    pcb[pid].stack = stack;
+    pcb[pid].stack_va = stack;
+    pcb[pid].stack_size = stack_size;
+    pcb[pid].shm_attached = 0;
+    sp_memset(&pcb[pid].select, 0, sizeof(ipc_set_t));
+
+    return pid;
+}
+
+/**
+ * Returns a process id and its runtime stack after a failed creation
+ * @param pid - the process id
+ */
+void kproc_release(int pid) {
+    kmem_page_free(pcb[pid].stack, pcb[pid].stack_size / PAGE_SIZE);
+    pcb[pid].stack = NULL;
+    pcb[pid].stack_va = NULL;
+    pcb[pid].stack_size = 0;
+    pcb[pid].state = AVAILABLE;
+    queue_in(&available_q, pid);
+}
+
+/**
+ * Start a new process
+ * @param proc_name  The process title
+ * @param proc_ptr   function pointer for the process
+ * @param queue      the run queue in which this process belongs; passing
+ *                   one of run_q[] sets the initial process priority
+ * @param stack_size runtime stack size in bytes; rounded up to whole pages
+ * @return the process id; -1 if the process could not be created
+ */
+int kproc_exec_stack(char *proc_name, void *proc_ptr, plist_t *queue, int stack_size) {
+    int pid; 
+    char *stack;
+
+    // Ensure that valid parameters have been specified and panic otherwise
+	if(!proc_name||!proc_ptr||!queue){
+    	panic("Prameters not specified\n");
+	} 
+
+    pid = kproc_alloc(proc_name, stack_size);
+    if (pid < 0) {
+        return -1;
     }
 
+    // Give the process its own address space; the idle task runs in
+    // whichever address space is loaded and keeps its identity mapped stack
+    if (pid != 0 && kpage_create(pid) != 0) {
+        kproc_release(pid);
+        panic_warn("Unable to allocate process address space\n");
+        return -1;
+    }
+
+    stack = pcb[pid].stack;
+    stack_size = pcb[pid].stack_size;
+
+    // Only the trapframe needs to be initialized; the rest of the stack is
+    // filled only when the high-water mark is being measured
+#if PROC_STACK_WATERMARK
+    sp_memset(stack, PROC_STACK_FILL, stack_size - sizeof(trapframe_t));
+#endif
+    *(unsigned int *)stack = PROC_STACK_CANARY;
+
     // Allocate the trapframe data
-    pcb[pid].trapframe_p = (trapframe_t *)&stack[pid][PROC_STACK_SIZE - sizeof(trapframe_t)];
+    pcb[pid].trapframe_p = (trapframe_t *)&stack[stack_size - sizeof(trapframe_t)];
+    sp_memset(pcb[pid].trapframe_p, 0, sizeof(trapframe_t));
 
     // Set the instruction pointer in the trapframe
     pcb[pid].trapframe_p->eip = (unsigned int)proc_ptr;
@@ -147,13 +534,78 @@ void kproc_exec(char *proc_name, void *proc_ptr, queue_t *queue) {
     pcb[pid].trapframe_p->fs = get_fs();
     pcb[pid].trapframe_p->gs = get_gs();
 
-    // Set the process run queue
-    pcb[pid].queue = queue;
+    // Derive the process priority from the requested run queue
+    if (queue >= &run_q[0] && queue < &run_q[PRIO_LEVELS]) {
+        pcb[pid].priority = queue - &run_q[0];
+    }
+    pcb[pid].base_priority = pcb[pid].priority;
 
-    // Move the proces into the associated run queue
-    queue_in(pcb[pid].queue, pid);
+    // Move the process into the associated run queue
+    if (queue == &idle_q || (queue >= &run_q[0] && queue < &run_q[PRIO_LEVELS])) {
+        kproc_enqueue(pid);
+    } else {
+        plist_in(queue, pid);
+    }
 
     printf("Executed process %s (%d)\n", pcb[pid].name, pid);
+
+    return pid;
+}
+
+/**
+ * Duplicates a process
+ * The child gets a copy of the parent's stack at the same address and
+ * shares the parent's heap pages copy-on-write. It resumes from the same
+ * trapframe, with 0 rather than its pid as the system call result.
+ * @param  ppid - the parent process id
+ * @return the child process id; -1 if the process could not be created
+ */
+int kproc_fork(int ppid) {
+    int pid;
+    int copied;
+
+    // The idle task has no address space of its own to duplicate
+    if (ppid <= 0 || ppid > PID_MAX || pcb[ppid].page_dir == NULL) {
+        return -1;
+    }
+
+    pid = kproc_alloc(pcb[ppid].name, pcb[ppid].stack_size);
+    if (pid < 0) {
+        return -1;
+    }
+
+    // The stack holds pointers into itself, so it is copied up front and
+    // mapped at the same address
+    sp_memcpy(pcb[pid].stack, pcb[ppid].stack, pcb[pid].stack_size);
+
+    copied = kpage_fork(ppid, pid);
+    if (copied < 0) {
+        kproc_release(pid);
+        panic_warn("Unable to allocate process address space\n");
+        return -1;
+    }
+    copied += pcb[pid].stack_size / PAGE_SIZE;
+
+    pcb[pid].trapframe_p = (trapframe_t *)(pcb[pid].stack + ((char *)pcb[ppid].trapframe_p - pcb[ppid].stack));
+    pcb[pid].trapframe_p->ebx = 0;
+
+    // Inherit the scheduling parameters, but not a deadline reservation
+    pcb[pid].quantum = pcb[ppid].quantum;
+    pcb[pid].priority = pcb[ppid].base_priority;
+    pcb[pid].base_priority = pcb[ppid].base_priority;
+
+    if (pcb[ppid].sched_class == SCHED_FAIR) {
+        pcb[pid].sched_class = SCHED_FAIR;
+        pcb[pid].nice = pcb[ppid].nice;
+        pcb[pid].weight = pcb[ppid].weight;
+        pcb[pid].vruntime = pcb[ppid].vruntime;
+    }
+
+    kproc_enqueue(pid);
+
+    printf("Forked process %s (%d) from %d, %d pages copied\n", pcb[pid].name, pid, ppid, copied);
+
+    return pid;
 }
 
 /**
@@ -177,40 +629,85 @@ void kproc_exit(int pid) {
         return;
     }
     
+    // Disarm the wakeup timer of a sleeping process
+    if(pcb[pid].state == SLEEPING){
+        ktimer_remove(pid);
+    }
+
+    // Remove a runnable process from its run queue
+    if(pcb[pid].state == RUNNING){
+        kproc_unqueue(pid);
+    }
+
+    // Remove a waiting process from its semaphore or mailbox wait queue
+    // and disarm the timer of a timed wait
+    if(pcb[pid].state == WAITING){
+        plist_remove(pid);
+        ktimer_remove(pid);
+        kselect_unregister(pid);
+        ksem_cancel(pid);
+    }
+
+    // Hand any semaphores the process holds to their next waiters
+    ksem_release_all(pid);
+
+    // Release any EDF reservation
+    kedf_release(pid);
+    pcb[pid].sched_class = SCHED_PRIO;
+
     // Clear the PCB for the process and set the process state to AVAILABLE
     pcb[pid].total_time = 0;//cleared total time
     pcb[pid].total_time = 0;//cleared active time
     pcb[pid].state = AVAILABLE; //prcoess state set to AVAILABLE
 
+    // Return the stack to the page frame allocator; the kernel runs on its
+    // own stack so this is safe even for the active process
+    kmem_page_free(pcb[pid].stack, pcb[pid].stack_size / PAGE_SIZE);
+    pcb[pid].stack = NULL;
+    pcb[pid].stack_va = NULL;
+    pcb[pid].stack_size = 0;
+    kshm_detach_all(pid);
+    kpage_destroy(pid);
+
     // Queue the pid back to the available queue
     queue_in(&available_q,pid);
 
     // if the pid is the active pid, then clear the active pid and
     if(pid == active_pid){
     // trigger the the process scheduler to schedule a new process
-        active_pid = 0; // clearing the active PID
+        active_pid = -1; // clearing the active PID
         kproc_schedule();//process scheduler is trigered for a new process
     }
     //Done!!
 }
 
+/**
+ * Ends a timed wait whose deadline passed before the process was woken
+ * The process is taken off its semaphore or mailbox wait queue (or every
+ * one it selected) and its system call returns IPC_TIMEOUT
+ * @param pid - the process id
+ */
+void kproc_timeout(int pid) {
+    plist_remove(pid);
+    kselect_unregister(pid);
+    ksem_cancel(pid);
+
+    pcb[pid].trapframe_p->ebx = IPC_TIMEOUT;
+    kproc_enqueue(pid);
+}
 
 /**
  * Kernel idle task
  */
 void ktask_idle() {
-    int i;
-
     // Indicate that the Idle Task has started
     cons_printf("idle_task started\n");
 
     // Process run loop
     while (1) {
-        cons_printf("idle_task running\n");
+        idle_halts++;
 
-        // busy loop/delay
-        for (i = 0; i < IO_DELAY_LOOP; i++) {
-            IO_DELAY();
-        }
+        // Halt the CPU until the next interrupt
+        asm("sti; hlt");
     }
 }
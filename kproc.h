@@ -9,14 +9,28 @@
 #define KPROC_H
 
 #ifndef ASSEMBLER
-#include "queue.h"
+#include "plist.h"
 #include "trapframe.h"
 
 // Kernel process functions
 void kproc_schedule();
 void kproc_load(trapframe_t *trapframe);
-void kproc_exec(char *proc_name, void *func_ptr, queue_t *queue);
+void kproc_exec(char *proc_name, void *func_ptr, plist_t *queue);
+int kproc_exec_stack(char *proc_name, void *func_ptr, plist_t *queue, int stack_size);
+int kproc_fork(int ppid);
+int kproc_stack_check(int pid);
+int kproc_stack_used(int pid);
 void kproc_exit(int pid);
+void kproc_timeout(int pid);
+void kproc_enqueue(int pid);
+void kproc_requeue(int pid);
+int kproc_dequeue();
+void kproc_unqueue(int pid);
+int kproc_set_priority(int pid, int prio);
+void kproc_boost_priority(int pid, int prio);
+int kproc_set_nice(int pid, int nice);
+int kproc_set_deadline(int pid, int period, int runtime, int deadline);
+int kproc_set_quantum(int pid, int ticks);
 
 // Kernel tasks
 void ktask_idle();
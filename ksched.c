@@ -0,0 +1,40 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Scheduler Policies
+ */
+#include "spede.h"
+#include "kernel.h"
+#include "kutil.h"
+#include "ksched.h"
+
+// Scheduler policies, indexed by SCHED_POLICY_* value
+sched_ops_t *sched_policies[] = {
+    &sched_rr_ops,
+    &sched_stride_ops
+};
+
+// Active scheduler policy
+sched_ops_t *sched_ops;
+
+// Number of processes queued in the active policy
+int sched_nr_running;
+
+/**
+ * Selects and initializes the scheduler policy
+ * @param policy - one of the SCHED_POLICY_* values
+ */
+void ksched_init(int policy) {
+    if (policy < 0 || policy >= sizeof(sched_policies) / sizeof(sched_policies[0])) {
+        panic_warn("Invalid scheduler policy, using round robin\n");
+        policy = SCHED_POLICY_RR;
+    }
+
+    sched_ops = sched_policies[policy];
+    sched_nr_running = 0;
+    sched_ops->init();
+
+    printf("Scheduler policy: %s\n", sched_ops->name);
+}
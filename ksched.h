@@ -0,0 +1,50 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Scheduler Policies
+ */
+#ifndef KSCHED_H
+#define KSCHED_H
+
+// Scheduler policies
+#define SCHED_POLICY_RR 0           // round robin within fixed priority levels
+#define SCHED_POLICY_STRIDE 1       // stride scheduling by weight
+
+// Scheduler policy selected at boot
+// Can be overridden, such as: EXTRA_CFLAGS=-DSCHED_POLICY=1
+#ifndef SCHED_POLICY
+#define SCHED_POLICY SCHED_POLICY_RR
+#endif
+
+// Scheduler policy operations
+// Policies only ever see processes other than the kernel idle task
+typedef struct {
+    char *name;                         // policy name
+    void (*init)();                     // initializes policy data
+    void (*enqueue)(int pid);           // a process has become runnable
+    void (*dequeue)(int pid);           // removes a specific runnable process
+    int (*pick_next)();                 // removes the next process to run; -1 if none
+    void (*tick)(int pid, int ticks);   // charges CPU time to the active process
+    void (*yield)(int pid);             // the active process gave up the CPU but is still runnable
+    int (*check_preempt)(int pid);      // 1 if a runnable process should replace the active process
+} sched_ops_t;
+
+// Active scheduler policy
+extern sched_ops_t *sched_ops;
+
+// Number of processes queued in the active policy
+extern int sched_nr_running;
+
+// Available scheduler policies
+extern sched_ops_t sched_rr_ops;
+extern sched_ops_t sched_stride_ops;
+
+/**
+ * Selects and initializes the scheduler policy
+ * @param policy - one of the SCHED_POLICY_* values
+ */
+void ksched_init(int policy);
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Round Robin Scheduler Policy
+ *
+ * Priority class processes run round robin within fixed priority levels,
+ * and the highest non-empty level is found with a bitmap. Fair class
+ * processes run by virtual runtime when no priority class process is
+ * runnable.
+ */
+#include "spede.h"
+#include "kernel.h"
+#include "kutil.h"
+#include "plist.h"
+#include "kfair.h"
+#include "ksched.h"
+
+/**
+ * Initializes the run queues
+ */
+void ksched_rr_init() {
+    int i;
+
+    for (i = 0; i < PRIO_LEVELS; i++) {
+        plist_init(&run_q[i]);
+    }
+    run_q_map = 0;
+
+    kfair_init();
+}
+
+/**
+ * Places a process on the run queue that matches its priority
+ * @param pid - the process id
+ */
+void ksched_rr_enqueue(int pid) {
+    int prio;
+
+    if (pcb[pid].sched_class == SCHED_FAIR) {
+        kfair_enqueue(pid);
+        return;
+    }
+
+    prio = pcb[pid].priority;
+    plist_in(&run_q[prio], pid);
+
+    // Flag the priority level as having runnable processes
+    run_q_map |= (1 << prio);
+}
+
+/**
+ * Removes a runnable process from the run queue it is waiting on
+ * @param pid - the process id
+ */
+void ksched_rr_dequeue(int pid) {
+    if (pcb[pid].sched_class == SCHED_FAIR) {
+        kfair_remove(pid);
+        return;
+    }
+
+    plist_remove(pid);
+
+    if (run_q[pcb[pid].priority].size == 0) {
+        run_q_map &= ~(1 << pcb[pid].priority);
+    }
+}
+
+/**
+ * Removes the highest priority runnable process
+ * Priority class processes run ahead of fair class processes
+ * @return the process id; -1 if nothing is runnable
+ */
+int ksched_rr_pick_next() {
+    int pid = -1;
+    int prio;
+
+    if (run_q_map == 0) {
+        return kfair_dequeue();
+    }
+
+    // The lowest set bit is the highest priority non-empty level
+    prio = bit_first_set(run_q_map);
+    plist_out(&run_q[prio], &pid);
+
+    if (run_q[prio].size == 0) {
+        run_q_map &= ~(1 << prio);
+    }
+
+    return pid;
+}
+
+/**
+ * Charges CPU time to the active process
+ * @param pid   - the process id
+ * @param ticks - number of ticks the process ran
+ */
+void ksched_rr_tick(int pid, int ticks) {
+    if (pcb[pid].sched_class == SCHED_FAIR) {
+        kfair_account(pid, ticks);
+    }
+}
+
+/**
+ * Returns a preempted process to the tail of its run queue
+ * @param pid - the process id
+ */
+void ksched_rr_yield(int pid) {
+    ksched_rr_enqueue(pid);
+}
+
+/**
+ * Determines if a runnable process should replace the active process
+ * @param pid - the active process id
+ * @return 1 if the process should be preempted; 0 otherwise
+ */
+int ksched_rr_check_preempt(int pid) {
+    // Priority class processes always run ahead of the fair class
+    if (pcb[pid].sched_class == SCHED_FAIR) {
+        return run_q_map != 0;
+    }
+
+    // A higher priority process has become runnable
+    return run_q_map != 0 && bit_first_set(run_q_map) < pcb[pid].priority;
+}
+
+// Round robin policy operations
+sched_ops_t sched_rr_ops = {
+    "rr",
+    ksched_rr_init,
+    ksched_rr_enqueue,
+    ksched_rr_dequeue,
+    ksched_rr_pick_next,
+    ksched_rr_tick,
+    ksched_rr_yield,
+    ksched_rr_check_preempt
+};
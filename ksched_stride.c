@@ -0,0 +1,126 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Stride Scheduler Policy
+ *
+ * Each process holds tickets equal to the weight of its nice value and
+ * advances its pass by a stride inversely proportional to its tickets for
+ * every tick it runs. The runnable process with the lowest pass runs next.
+ * Priorities are ignored by this policy.
+ */
+#include "spede.h"
+#include "kernel.h"
+#include "kfair.h"
+#include "ksched.h"
+
+// Stride of a process holding a single ticket
+#define STRIDE_1 (1 << 20)
+
+// Runnable processes
+int stride_q[PROC_MAX];
+int stride_q_size;
+
+// Pass of the most recently selected process
+unsigned int stride_pass;
+
+/**
+ * Initializes the run queue
+ */
+void ksched_stride_init() {
+    stride_q_size = 0;
+    stride_pass = 0;
+}
+
+/**
+ * Adds a runnable process
+ * @param pid - the process id
+ */
+void ksched_stride_enqueue(int pid) {
+    // Processes that slept or just joined may not bank CPU time
+    if ((int)(pcb[pid].pass - stride_pass) < 0) {
+        pcb[pid].pass = stride_pass;
+    }
+
+    stride_q[stride_q_size++] = pid;
+}
+
+/**
+ * Removes a runnable process
+ * @param pid - the process id
+ */
+void ksched_stride_dequeue(int pid) {
+    int i;
+
+    for (i = 0; i < stride_q_size; i++) {
+        if (stride_q[i] == pid) {
+            stride_q[i] = stride_q[--stride_q_size];
+            return;
+        }
+    }
+}
+
+/**
+ * Removes the runnable process with the lowest pass
+ * @return the process id; -1 if nothing is runnable
+ */
+int ksched_stride_pick_next() {
+    int i;
+    int min = 0;
+    int pid;
+
+    if (stride_q_size == 0) {
+        return -1;
+    }
+
+    for (i = 1; i < stride_q_size; i++) {
+        if ((int)(pcb[stride_q[i]].pass - pcb[stride_q[min]].pass) < 0) {
+            min = i;
+        }
+    }
+
+    pid = stride_q[min];
+    stride_q[min] = stride_q[--stride_q_size];
+    stride_pass = pcb[pid].pass;
+
+    return pid;
+}
+
+/**
+ * Advances the pass of the active process
+ * @param pid   - the process id
+ * @param ticks - number of ticks the process ran
+ */
+void ksched_stride_tick(int pid, int ticks) {
+    pcb[pid].pass += (unsigned int)ticks * (STRIDE_1 / pcb[pid].weight);
+}
+
+/**
+ * Returns a preempted process to the run queue, keeping its pass
+ * @param pid - the process id
+ */
+void ksched_stride_yield(int pid) {
+    stride_q[stride_q_size++] = pid;
+}
+
+/**
+ * Stride scheduling only switches processes when the time slice expires
+ * @param pid - the active process id
+ * @return 0
+ */
+int ksched_stride_check_preempt(int pid) {
+    return 0;
+}
+
+// Stride policy operations
+sched_ops_t sched_stride_ops = {
+    "stride",
+    ksched_stride_init,
+    ksched_stride_enqueue,
+    ksched_stride_dequeue,
+    ksched_stride_pick_next,
+    ksched_stride_tick,
+    ksched_stride_yield,
+    ksched_stride_check_preempt
+};
@@ -0,0 +1,205 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Shared Memory Segments
+ *
+ * A segment is a run of page frames mapped at the same address in every
+ * process that attaches it, so processes can exchange buffers and
+ * pointers into them without the kernel copying anything. Each process
+ * tracks the segments it has attached in a bit mask.
+ */
+#include "spede.h"
+#include "kernel.h"
+#include "kutil.h"
+#include "kmem.h"
+#include "kpage.h"
+#include "kshm.h"
+#include "string.h"
+
+shm_t shm_segments[SHM_MAX];
+
+/**
+ * Finds a segment by name
+ * @param  name - segment name
+ * @return the segment id; -1 if there is no such segment
+ */
+int kshm_find(char *name) {
+    int id;
+    int i;
+
+    for (id = 0; id < SHM_MAX; id++) {
+        if (shm_segments[id].frames == NULL) {
+            continue;
+        }
+
+        for (i = 0; i < SHM_NAME_LEN; i++) {
+            if (shm_segments[id].name[i] != name[i] || name[i] == '\0') {
+                break;
+            }
+        }
+
+        if (i == SHM_NAME_LEN || (shm_segments[id].name[i] == '\0' && name[i] == '\0')) {
+            return id;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Frees a segment once no process has it mapped and its creator has
+ * released it
+ * @param id - the segment id
+ */
+void kshm_put(int id) {
+    if (shm_segments[id].attached > 0 || shm_segments[id].creator >= 0) {
+        return;
+    }
+
+    kmem_page_free(shm_segments[id].frames, shm_segments[id].pages);
+    shm_segments[id].frames = NULL;
+    shm_segments[id].pages = 0;
+    shm_segments[id].name[0] = '\0';
+}
+
+/**
+ * Initializes the segment table
+ */
+void kshm_init() {
+    int id;
+
+    for (id = 0; id < SHM_MAX; id++) {
+        shm_segments[id].name[0] = '\0';
+        shm_segments[id].frames = NULL;
+        shm_segments[id].pages = 0;
+        shm_segments[id].attached = 0;
+        shm_segments[id].creator = -1;
+    }
+}
+
+/**
+ * Creates a zero-filled segment, or finds an existing one by name
+ * The creating process holds a reference to a new segment, so it is not
+ * freed before being attached, until it detaches the segment or exits
+ * @param  pid  - the process id
+ * @param  name - segment name
+ * @param  size - segment size in bytes; must match an existing segment
+ * @return the segment id; -1 on error
+ */
+int kshm_create(int pid, char *name, int size) {
+    int id;
+
+    if (name == NULL || name[0] == '\0' || size <= 0 || size > SHM_SIZE_MAX) {
+        return -1;
+    }
+
+    id = kshm_find(name);
+    if (id >= 0) {
+        return shm_segments[id].pages == PAGE_COUNT(size) ? id : -1;
+    }
+
+    for (id = 0; id < SHM_MAX; id++) {
+        if (shm_segments[id].frames == NULL) {
+            break;
+        }
+    }
+
+    if (id == SHM_MAX) {
+        return -1;
+    }
+
+    shm_segments[id].frames = kmem_page_alloc(PAGE_COUNT(size));
+    if (shm_segments[id].frames == NULL) {
+        return -1;
+    }
+
+    sp_memset(shm_segments[id].frames, 0, PAGE_COUNT(size) * PAGE_SIZE);
+    sp_strncpy(shm_segments[id].name, name, SHM_NAME_LEN);
+    shm_segments[id].name[SHM_NAME_LEN] = '\0';
+    shm_segments[id].pages = PAGE_COUNT(size);
+    shm_segments[id].attached = 0;
+    shm_segments[id].creator = pid;
+
+    return id;
+}
+
+/**
+ * Maps a segment into a process
+ * @param  pid - the process id
+ * @param  id  - the segment id
+ * @return the address of the segment; 0 on error
+ */
+unsigned int kshm_attach(int pid, int id) {
+    if (id < 0 || id >= SHM_MAX || shm_segments[id].frames == NULL || pcb[pid].page_dir == NULL) {
+        return 0;
+    }
+
+    // Attaching twice returns the existing mapping
+    if (pcb[pid].shm_attached & (1 << id)) {
+        return SHM_ADDR(id);
+    }
+
+    if (kpage_map(pid, SHM_ADDR(id), (unsigned int)shm_segments[id].frames, shm_segments[id].pages) != 0) {
+        return 0;
+    }
+
+    pcb[pid].shm_attached |= 1 << id;
+    shm_segments[id].attached++;
+
+    return SHM_ADDR(id);
+}
+
+/**
+ * Unmaps a segment from a process; the segment is freed once no process
+ * has it mapped and its creator has released it
+ * @param  pid  - the process id
+ * @param  addr - address returned by kshm_attach
+ * @return 0 on success; -1 on error
+ */
+int kshm_detach(int pid, unsigned int addr) {
+    int id;
+
+    if (addr < USER_SHM_BASE || (addr - USER_SHM_BASE) % SHM_SIZE_MAX != 0) {
+        return -1;
+    }
+
+    id = (addr - USER_SHM_BASE) / SHM_SIZE_MAX;
+    if (id >= SHM_MAX || !(pcb[pid].shm_attached & (1 << id))) {
+        return -1;
+    }
+
+    kpage_unmap_shared(pid, addr, shm_segments[id].pages);
+    pcb[pid].shm_attached &= ~(1 << id);
+    shm_segments[id].attached--;
+
+    // Detaching also releases the creator's reference
+    if (shm_segments[id].creator == pid) {
+        shm_segments[id].creator = -1;
+    }
+
+    kshm_put(id);
+
+    return 0;
+}
+
+/**
+ * Unmaps every segment from an exiting process and releases the segments
+ * it created
+ * @param pid - the process id
+ */
+void kshm_detach_all(int pid) {
+    int id;
+
+    for (id = 0; id < SHM_MAX; id++) {
+        if (pcb[pid].shm_attached & (1 << id)) {
+            kshm_detach(pid, SHM_ADDR(id));
+        }
+
+        if (shm_segments[id].frames != NULL && shm_segments[id].creator == pid) {
+            shm_segments[id].creator = -1;
+            kshm_put(id);
+        }
+    }
+}
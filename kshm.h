@@ -0,0 +1,75 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Shared Memory Segments
+ */
+#ifndef KSHM_H
+#define KSHM_H
+
+// Maximum number of shared memory segments
+#define SHM_MAX 16
+
+// Maximum segment name length
+#define SHM_NAME_LEN 16
+
+// Largest segment; also the spacing of the segment slots
+#define SHM_SIZE_MAX 0x00400000
+
+// Address at which a segment is mapped in every attached process
+#define SHM_ADDR(id) (USER_SHM_BASE + (id) * SHM_SIZE_MAX)
+
+// Shared memory segment
+typedef struct {
+    char name[SHM_NAME_LEN + 1];    // segment name, empty if unused
+    void *frames;                   // backing page frames
+    int pages;                      // number of page frames
+    int attached;                   // processes the segment is mapped in
+    int creator;                    // creating process while it holds its
+                                    // reference, -1 once released
+} shm_t;
+
+extern shm_t shm_segments[SHM_MAX];
+
+/**
+ * Initializes the segment table
+ */
+void kshm_init();
+
+/**
+ * Creates a zero-filled segment, or finds an existing one by name
+ * The creating process holds a reference to a new segment, so it is not
+ * freed before being attached, until it detaches the segment or exits
+ * @param  pid  - the process id
+ * @param  name - segment name
+ * @param  size - segment size in bytes; must match an existing segment
+ * @return the segment id; -1 on error
+ */
+int kshm_create(int pid, char *name, int size);
+
+/**
+ * Maps a segment into a process
+ * @param  pid - the process id
+ * @param  id  - the segment id
+ * @return the address of the segment; 0 on error
+ */
+unsigned int kshm_attach(int pid, int id);
+
+/**
+ * Unmaps a segment from a process; the segment is freed once no process
+ * has it mapped and its creator has released it
+ * @param  pid  - the process id
+ * @param  addr - address returned by kshm_attach
+ * @return 0 on success; -1 on error
+ */
+int kshm_detach(int pid, unsigned int addr);
+
+/**
+ * Unmaps every segment from an exiting process and releases the segments
+ * it created
+ * @param pid - the process id
+ */
+void kshm_detach_all(int pid);
+
+#endif
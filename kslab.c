@@ -0,0 +1,292 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Slab Allocator
+ *
+ * Each slab is a single page frame filled with equally sized objects.
+ * Free objects are chained through their first word, so allocating and
+ * freeing only push or pop a list; objects are never constructed or
+ * cleared. Slab headers are kept off the page in a table with one kslab_t
+ * per page frame, so a page holds a whole number of objects (two of
+ * kmalloc-2048) and the owning slab of any object is found from its frame
+ * number.
+ *
+ * Slabs with free objects are kept on the cache's partial list. A slab
+ * whose objects are all free is handed back to the page frame allocator
+ * unless it is the cache's only partial slab.
+ *
+ * kmalloc requests above the largest size class get whole page frames,
+ * with the header of their first frame marked as having no cache, so a
+ * power-of-two buffer of a page or more takes exactly that many frames.
+ */
+#include "spede.h"
+#include "kernel.h"
+#include "kutil.h"
+#include "kmem.h"
+#include "kslab.h"
+
+// Names of the kmalloc size class caches
+char *kmalloc_names[KMALLOC_CLASSES] = {
+    "kmalloc-32", "kmalloc-64", "kmalloc-128", "kmalloc-256",
+    "kmalloc-512", "kmalloc-1024", "kmalloc-2048"
+};
+
+kslab_cache_t kmalloc_caches[KMALLOC_CLASSES];
+
+// Slab headers, indexed by page frame number
+kslab_t kslab_frames[KMEM_FRAMES];
+
+/**
+ * Obtains the header of the slab an object belongs to
+ * @param  obj - the object
+ * @return the slab header
+ */
+kslab_t *kslab_of(void *obj) {
+    return &kslab_frames[(unsigned int)obj >> PAGE_SHIFT];
+}
+
+/**
+ * Obtains the address of the page frames backing a slab
+ * @param  slab - the slab header
+ * @return address of the first frame
+ */
+void *kslab_base(kslab_t *slab) {
+    return (void *)((slab - kslab_frames) << PAGE_SHIFT);
+}
+
+/**
+ * Links a slab onto the front of its cache's partial list
+ * @param slab - the slab
+ */
+void kslab_link(kslab_t *slab) {
+    slab->prev = NULL;
+    slab->next = slab->cache->partial;
+
+    if (slab->next != NULL) {
+        slab->next->prev = slab;
+    }
+
+    slab->cache->partial = slab;
+}
+
+/**
+ * Unlinks a slab from its cache's partial list
+ * @param slab - the slab
+ */
+void kslab_unlink(kslab_t *slab) {
+    if (slab->prev != NULL) {
+        slab->prev->next = slab->next;
+    } else {
+        slab->cache->partial = slab->next;
+    }
+
+    if (slab->next != NULL) {
+        slab->next->prev = slab->prev;
+    }
+
+    slab->next = NULL;
+    slab->prev = NULL;
+}
+
+/**
+ * Adds a new slab to a cache
+ * @param  cache - the cache
+ * @return the slab; NULL if no page frame is available
+ */
+kslab_t *kslab_grow(kslab_cache_t *cache) {
+    kslab_t *slab;
+    char *obj;
+    int i;
+
+    obj = kmem_page_alloc(1);
+    if (obj == NULL) {
+        return NULL;
+    }
+
+    slab = kslab_of(obj);
+    slab->cache = cache;
+    slab->in_use = 0;
+    slab->pages = 1;
+    slab->free = NULL;
+
+    // Chain every object onto the free list
+    for (i = 0; i < cache->per_slab; i++) {
+        *(void **)obj = slab->free;
+        slab->free = obj;
+        obj += cache->size;
+    }
+
+    cache->slabs++;
+    kslab_link(slab);
+
+    return slab;
+}
+
+/**
+ * Initializes the kmalloc size class caches
+ */
+void kslab_init() {
+    int i;
+
+    for (i = 0; i < KMALLOC_CLASSES; i++) {
+        kslab_cache_init(&kmalloc_caches[i], kmalloc_names[i], 1 << (KMALLOC_MIN_SHIFT + i));
+    }
+}
+
+/**
+ * Initializes a cache of objects
+ * @param cache - the cache
+ * @param name  - cache name
+ * @param size  - object size in bytes
+ */
+void kslab_cache_init(kslab_cache_t *cache, char *name, int size) {
+    // Objects must hold the free list link and stay word aligned
+    if (size < (int)sizeof(void *)) {
+        size = sizeof(void *);
+    }
+    size = (size + sizeof(int) - 1) & ~(sizeof(int) - 1);
+
+    if (size > PAGE_SIZE) {
+        panic("Slab object does not fit in a page");
+    }
+
+    cache->name = name;
+    cache->size = size;
+    cache->per_slab = PAGE_SIZE / size;
+    cache->partial = NULL;
+    cache->slabs = 0;
+    cache->in_use = 0;
+    cache->allocs = 0;
+    cache->frees = 0;
+    cache->fails = 0;
+}
+
+/**
+ * Allocates an object from a cache
+ * The object is not initialized
+ * @param  cache - the cache
+ * @return the object; NULL if no memory is available
+ */
+void *kslab_alloc(kslab_cache_t *cache) {
+    kslab_t *slab;
+    void *obj;
+
+    slab = cache->partial;
+    if (slab == NULL) {
+        slab = kslab_grow(cache);
+        if (slab == NULL) {
+            cache->fails++;
+            return NULL;
+        }
+    }
+
+    obj = slab->free;
+    slab->free = *(void **)obj;
+    slab->in_use++;
+
+    // A full slab leaves the partial list until an object is freed
+    if (slab->free == NULL) {
+        kslab_unlink(slab);
+    }
+
+    cache->in_use++;
+    cache->allocs++;
+
+    return obj;
+}
+
+/**
+ * Returns an object to its cache
+ * @param obj - object returned by kslab_alloc or kmalloc
+ */
+void kslab_free(void *obj) {
+    kslab_t *slab;
+    kslab_cache_t *cache;
+
+    slab = kslab_of(obj);
+    cache = slab->cache;
+
+    if (cache == NULL) {
+        panic_warn("Freeing an object that is not from a slab");
+        return;
+    }
+
+    // A full slab rejoins the partial list
+    if (slab->free == NULL) {
+        kslab_link(slab);
+    }
+
+    *(void **)obj = slab->free;
+    slab->free = obj;
+    slab->in_use--;
+
+    cache->in_use--;
+    cache->frees++;
+
+    // Keep one empty slab around so alloc/free pairs do not thrash
+    if (slab->in_use == 0 && (slab->prev != NULL || slab->next != NULL)) {
+        kslab_unlink(slab);
+        kmem_page_free(kslab_base(slab), slab->pages);
+        cache->slabs--;
+    }
+}
+
+/**
+ * Allocates kernel memory
+ * Small requests come from the size class caches; larger requests are
+ * given whole page frames
+ * @param  size - number of bytes
+ * @return the memory; NULL if no memory is available
+ */
+void *kmalloc(int size) {
+    kslab_t *slab;
+    void *mem;
+    int i;
+
+    if (size <= 0) {
+        return NULL;
+    }
+
+    for (i = 0; i < KMALLOC_CLASSES; i++) {
+        if (size <= kmalloc_caches[i].size) {
+            return kslab_alloc(&kmalloc_caches[i]);
+        }
+    }
+
+    mem = kmem_page_alloc(PAGE_COUNT(size));
+    if (mem == NULL) {
+        return NULL;
+    }
+
+    slab = kslab_of(mem);
+    slab->cache = NULL;
+    slab->next = NULL;
+    slab->prev = NULL;
+    slab->free = NULL;
+    slab->in_use = 1;
+    slab->pages = PAGE_COUNT(size);
+
+    return mem;
+}
+
+/**
+ * Frees memory returned by kmalloc
+ * @param ptr - the memory; NULL is ignored
+ */
+void kfree(void *ptr) {
+    kslab_t *slab;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    slab = kslab_of(ptr);
+
+    if (slab->cache == NULL) {
+        kmem_page_free(ptr, slab->pages);
+    } else {
+        kslab_free(ptr);
+    }
+}
@@ -0,0 +1,86 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Slab Allocator
+ */
+#ifndef KSLAB_H
+#define KSLAB_H
+
+// Smallest and largest kmalloc size classes (powers of two)
+#define KMALLOC_MIN_SHIFT 5
+#define KMALLOC_MAX_SHIFT 11
+#define KMALLOC_CLASSES (KMALLOC_MAX_SHIFT - KMALLOC_MIN_SHIFT + 1)
+
+struct kslab_cache_s;
+
+// Header of the page frames backing a slab, kept off the page
+typedef struct kslab_s {
+    struct kslab_cache_s *cache;    // owning cache; NULL for a large kmalloc
+    struct kslab_s *next;           // next slab with free objects
+    struct kslab_s *prev;           // previous slab with free objects
+    void *free;                     // list of free objects in the slab
+    int in_use;                     // objects allocated from the slab
+    int pages;                      // page frames backing the slab
+} kslab_t;
+
+// Cache of equally sized objects
+typedef struct kslab_cache_s {
+    char *name;                     // cache name
+    int size;                       // object size in bytes
+    int per_slab;                   // objects that fit in one slab
+    kslab_t *partial;               // slabs with at least one free object
+    int slabs;                      // slabs currently held by the cache
+    int in_use;                     // objects currently allocated
+    int allocs;                     // total allocations
+    int frees;                      // total frees
+    int fails;                      // allocations that could not be satisfied
+} kslab_cache_t;
+
+// Caches backing kmalloc, one per size class
+extern kslab_cache_t kmalloc_caches[KMALLOC_CLASSES];
+
+/**
+ * Initializes the kmalloc size class caches
+ */
+void kslab_init();
+
+/**
+ * Initializes a cache of objects
+ * @param cache - the cache
+ * @param name  - cache name
+ * @param size  - object size in bytes
+ */
+void kslab_cache_init(kslab_cache_t *cache, char *name, int size);
+
+/**
+ * Allocates an object from a cache
+ * The object is not initialized
+ * @param  cache - the cache
+ * @return the object; NULL if no memory is available
+ */
+void *kslab_alloc(kslab_cache_t *cache);
+
+/**
+ * Returns an object to its cache
+ * @param obj - object returned by kslab_alloc or kmalloc
+ */
+void kslab_free(void *obj);
+
+/**
+ * Allocates kernel memory
+ * Small requests come from the size class caches; larger requests are
+ * given whole page frames
+ * @param  size - number of bytes
+ * @return the memory; NULL if no memory is available
+ */
+void *kmalloc(int size);
+
+/**
+ * Frees memory returned by kmalloc
+ * @param ptr - the memory; NULL is ignored
+ */
+void kfree(void *ptr);
+
+#endif
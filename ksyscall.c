@@ -4,10 +4,23 @@
 #include "kutil.h"
 #include "string.h"
 #include "queue.h"
+#include "ktimer.h"
+#include "kmem.h"
+#include "kslab.h"
+#include "kpage.h"
+#include "kshm.h"
+#include "kedf.h"
 #include "ksyscall.h"
 
-int mbox_enqueue(msg_t *msg, int mbox_num);
-int mbox_dequeue(msg_t *msg, int mbox_num);
+int mbox_enqueue(mbox_hdr_t *hdr, unsigned char *data, int mbox_num);
+int mbox_dequeue(msg_t *msg, int size, int mbox_num);
+int mbox_full(int mbox_num, int size);
+int mbox_empty(int mbox_num);
+mailbox_t *kmbox_get(int mbox_num);
+void kmbox_deliver(int pid, mbox_hdr_t *hdr, unsigned char *data);
+void kselect_notify(unsigned int *pids);
+int kmbox_send(mailbox_t *mbox, int mbox_num, msg_t *msg);
+void kmbox_deliver_pages(int pid, msg_pages_t *loan);
 
 /**
  * System call kernel handler: get_sys_time
@@ -24,6 +37,60 @@ void ksyscall_get_sys_time() {
     pcb[active_pid].trapframe_p -> ebx = system_time/100;
 }
 
+/**
+ * System call kernel handler: get_idle_stats
+ * Copies the idle statistics to the address passed in via EBX
+ */
+void ksyscall_get_idle_stats() {
+    idle_stats_t *stats;
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    stats = (idle_stats_t *)pcb[active_pid].trapframe_p->ebx;
+    if (stats == NULL) {
+        return;
+    }
+
+    stats->idle_ticks = idle_ticks;
+    stats->total_ticks = system_time;
+    stats->halts = idle_halts;
+    stats->avg_halt_ticks = idle_halts > 0 ? idle_ticks / idle_halts : 0;
+}
+
+/**
+ * System call kernel handler: get_mem_stats
+ * Copies the physical memory statistics to the structure in EBX
+ */
+void ksyscall_get_mem_stats() {
+    mem_stats_t *stats;
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    stats = (mem_stats_t *)pcb[active_pid].trapframe_p->ebx;
+    if (stats == NULL) {
+        return;
+    }
+
+    stats->page_size = PAGE_SIZE;
+    stats->pages_total = mem_pages_total;
+    stats->pages_free = mem_pages_free;
+    stats->alloc_fails = mem_alloc_fails;
+    stats->page_faults = page_faults;
+    stats->zero_fills = page_zero_fills;
+    stats->cr3_loads = page_cr3_loads;
+    stats->cr3_skips = page_cr3_skips;
+    stats->forks = page_forks;
+    stats->fork_copies = page_fork_copies;
+    stats->cow_copies = page_cow_copies;
+    stats->page_loans = page_loans;
+}
+
 /**
  * System call kernel handler: get_proc_id
  * Returns the currently running process ID
@@ -69,11 +136,9 @@ void ksyscall_sleep() {
     if (active_pid < 0 || active_pid > PID_MAX) {
         //not doing anything
     }
-    // Calculate the wake time for the currently running process
-    pcb[active_pid].wake_time = pcb[active_pid].trapframe_p->eax*100 + system_time;
+    // Arm a wakeup timer for the currently running process
+    ktimer_add(active_pid, pcb[active_pid].trapframe_p->ebx*100 + system_time);
 
-    // Move the currently running process to the sleep queue
-    queue_in(&sleep_q,active_pid);
     // Change the running process state to SLEEPING
     pcb[active_pid].state = SLEEPING;
 
@@ -81,6 +146,250 @@ void ksyscall_sleep() {
     active_pid = -1;
 }
 
+/**
+ * System call kernel handler: set_proc_prio
+ * Changes the scheduling priority of the process passed in EBX to the
+ * priority passed in ECX. The result is returned via EBX.
+ */
+void ksyscall_set_proc_prio() {
+    int pid;
+    int prio;
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    pid  = pcb[active_pid].trapframe_p->ebx;
+    prio = pcb[active_pid].trapframe_p->ecx;
+
+    pcb[active_pid].trapframe_p->ebx = kproc_set_priority(pid, prio);
+}
+
+/**
+ * System call kernel handler: set_proc_quantum
+ * Changes the time slice of the process passed in EBX to the number of
+ * ticks passed in ECX. The result is returned via EBX.
+ */
+void ksyscall_set_proc_quantum() {
+    int pid;
+    int ticks;
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    pid   = pcb[active_pid].trapframe_p->ebx;
+    ticks = pcb[active_pid].trapframe_p->ecx;
+
+    pcb[active_pid].trapframe_p->ebx = kproc_set_quantum(pid, ticks);
+}
+
+/**
+ * System call kernel handler: set_proc_nice
+ * Moves the process passed in EBX into the fair scheduling class with
+ * the nice value passed in ECX. The result is returned via EBX.
+ */
+void ksyscall_set_proc_nice() {
+    int pid;
+    int nice;
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    pid  = pcb[active_pid].trapframe_p->ebx;
+    nice = pcb[active_pid].trapframe_p->ecx;
+
+    pcb[active_pid].trapframe_p->ebx = kproc_set_nice(pid, nice);
+}
+
+/**
+ * System call kernel handler: sched_set_deadline
+ * Moves the running process into the EDF class using the period (EBX),
+ * runtime (ECX) and deadline (EDX) in ticks. The result is returned via EBX.
+ */
+void ksyscall_sched_set_deadline() {
+    trapframe_t *tf;
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    tf = pcb[active_pid].trapframe_p;
+    tf->ebx = kproc_set_deadline(active_pid, tf->ebx, tf->ecx, tf->edx);
+}
+
+/**
+ * System call kernel handler: sched_yield_period
+ * Ends the current job of the running EDF process, which sleeps until its
+ * next period starts. Returns -1 via EBX if the process is not in the EDF
+ * class, otherwise 0 once the next period has started.
+ */
+void ksyscall_sched_yield_period() {
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    if (pcb[active_pid].sched_class != SCHED_EDF) {
+        pcb[active_pid].trapframe_p->ebx = -1;
+        return;
+    }
+
+    pcb[active_pid].trapframe_p->ebx = 0;
+    kedf_finish(active_pid);
+
+    // Clear the running PID so the process scheduler will run
+    active_pid = -1;
+}
+
+/**
+ * System call kernel handler: sched_get_deadline_stats
+ * Copies the deadline statistics of the process passed in EBX to the
+ * address passed in ECX. The result is returned via EBX.
+ */
+void ksyscall_sched_get_deadline_stats() {
+    int pid;
+    dl_stats_t *stats;
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    pid   = pcb[active_pid].trapframe_p->ebx;
+    stats = (dl_stats_t *)pcb[active_pid].trapframe_p->ecx;
+
+    if (pid < 0 || pid > PID_MAX || stats == NULL) {
+        pcb[active_pid].trapframe_p->ebx = -1;
+        return;
+    }
+
+    stats->period = pcb[pid].dl_period;
+    stats->runtime = pcb[pid].dl_runtime;
+    stats->deadline = pcb[pid].dl_deadline;
+    stats->overruns = pcb[pid].dl_overruns;
+    stats->misses = pcb[pid].dl_misses;
+
+    pcb[active_pid].trapframe_p->ebx = 0;
+}
+
+/**
+ * System call kernel handler: get_stack_stats
+ * Copies the stack statistics of the process in EBX to the structure in ECX
+ * Returns 0 on success, -1 on error in EBX
+ */
+void ksyscall_get_stack_stats() {
+    int pid;
+    stack_stats_t *stats;
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    pid   = pcb[active_pid].trapframe_p->ebx;
+    stats = (stack_stats_t *)pcb[active_pid].trapframe_p->ecx;
+
+    if (pid < 0 || pid > PID_MAX || stats == NULL || pcb[pid].state == AVAILABLE) {
+        pcb[active_pid].trapframe_p->ebx = -1;
+        return;
+    }
+
+    stats->size = pcb[pid].stack_size;
+    stats->used = kproc_stack_used(pid);
+    stats->overflow = kproc_stack_check(pid) != 0;
+
+    pcb[active_pid].trapframe_p->ebx = 0;
+}
+
+/**
+ * System call kernel handler: proc_sbrk
+ * Moves the heap break of the running process by the increment in EBX
+ * Returns the previous break, or 0 on error, in EBX
+ */
+void ksyscall_proc_sbrk() {
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    pcb[active_pid].trapframe_p->ebx = kpage_sbrk(active_pid, (int)pcb[active_pid].trapframe_p->ebx);
+}
+
+/**
+ * System call kernel handler: proc_fork
+ * Duplicates the running process
+ * Returns the child pid, or -1 on error, in EBX; the child sees 0
+ */
+void ksyscall_proc_fork() {
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    pcb[active_pid].trapframe_p->ebx = kproc_fork(active_pid);
+}
+
+/**
+ * System call kernel handler: shm_create
+ * Creates or finds the segment named in EBX with the size in ECX
+ * Returns the segment id, or -1 on error, in EBX
+ */
+void ksyscall_shm_create() {
+    char name[SHM_NAME_LEN + 1];
+    char *user_name;
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    user_name = (char *)pcb[active_pid].trapframe_p->ebx;
+    if (user_name == NULL) {
+        pcb[active_pid].trapframe_p->ebx = -1;
+        return;
+    }
+
+    sp_strncpy(name, user_name, SHM_NAME_LEN);
+    name[SHM_NAME_LEN] = '\0';
+
+    pcb[active_pid].trapframe_p->ebx = kshm_create(active_pid, name, pcb[active_pid].trapframe_p->ecx);
+}
+
+/**
+ * System call kernel handler: shm_attach
+ * Maps the segment in EBX into the running process
+ * Returns the segment address, or 0 on error, in EBX
+ */
+void ksyscall_shm_attach() {
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    pcb[active_pid].trapframe_p->ebx = kshm_attach(active_pid, pcb[active_pid].trapframe_p->ebx);
+}
+
+/**
+ * System call kernel handler: shm_detach
+ * Unmaps the segment at the address in EBX from the running process
+ * Returns 0 on success, -1 on error, in EBX
+ */
+void ksyscall_shm_detach() {
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    pcb[active_pid].trapframe_p->ebx = kshm_detach(active_pid, pcb[active_pid].trapframe_p->ebx);
+}
+
 void ksyscall_proc_exit() {
     // Don't do anything if the running PID is invalid
     if (active_pid < 0 || active_pid > PID_MAX) {
@@ -90,6 +399,95 @@ void ksyscall_proc_exit() {
     kproc_exit(active_pid);
 }
 
+/**
+ * Determines if a semaphore id refers to an initialized semaphore
+ * @param  id - the semaphore id
+ * @return 1 if valid; 0 otherwise
+ */
+int ksem_valid(int id) {
+    return id >= 0 && id < SEMAPHORE_MAX && semaphores[id].init == SEMAPHORE_INITIALIZED;
+}
+
+/**
+ * Lends the priority of a blocked process to the holder of the semaphore
+ * it is waiting on, following the chain of holders that are themselves
+ * blocked on other semaphores
+ * @param pid - the blocked process
+ * @param id  - the semaphore the process is blocked on
+ */
+void ksem_inherit(int pid, int id) {
+    int prio;
+    int holder;
+    int depth;
+
+    // Only fixed priorities take part in priority inheritance
+    if (pcb[pid].sched_class != SCHED_PRIO) {
+        return;
+    }
+
+    prio = pcb[pid].priority;
+
+    for (depth = 0; depth < PROC_MAX && id >= 0; depth++) {
+        holder = semaphores[id].holder;
+
+        if (holder < 0 || pcb[holder].sched_class != SCHED_PRIO || pcb[holder].priority <= prio) {
+            break;
+        }
+
+        kproc_boost_priority(holder, prio);
+        sem_boosts++;
+
+        id = pcb[holder].blocked_on;
+    }
+}
+
+/**
+ * Computes the effective priority of a process: the highest of its base
+ * priority and the priorities of the processes waiting on the semaphores
+ * it holds
+ * @param  pid - the process id
+ * @return the effective priority
+ */
+int ksem_priority(int pid) {
+    int prio;
+    int id;
+    int waiter;
+
+    prio = pcb[pid].base_priority;
+
+    for (id = 0; id < SEMAPHORE_MAX; id++) {
+        if (semaphores[id].holder != pid) {
+            continue;
+        }
+
+        for (waiter = semaphores[id].wait_q.head; waiter != PLIST_NONE; waiter = pcb[waiter].list_next) {
+            if (pcb[waiter].sched_class == SCHED_PRIO && pcb[waiter].priority < prio) {
+                prio = pcb[waiter].priority;
+            }
+        }
+    }
+
+    return prio;
+}
+
+/**
+ * Recomputes the priority of a process from its base priority and the
+ * processes waiting on the semaphores it still holds
+ * @param pid - the process id
+ */
+void ksem_restore(int pid) {
+    int prio;
+
+    if (pcb[pid].sched_class != SCHED_PRIO) {
+        return;
+    }
+
+    prio = ksem_priority(pid);
+    if (prio != pcb[pid].priority) {
+        kproc_boost_priority(pid, prio);
+    }
+}
+
 // The "semaphore" passed in is a pointer to a variable that will contain the semaphore id. By default, this variable should be set to "SEMAPHORE_UNINITIALIZED" (-1).
 // If a call to sem_init() is called on a semaphore that is not already initialized (i.e. the semaphore id is set to SEMAPHORE_UNINITIALIZED), it should:
 // Check if the semaphore has indicated it is initialized in the kernel (via the semaphore init value). If not, you should:
@@ -104,22 +502,28 @@ void ksyscall_proc_exit() {
 void ksyscall_sem_init(){
     //declaring semaphore
     sem_t *sem;
+    int id;
+
     // Don't do anything if the running PID is invalid
     if (active_pid < 0 || active_pid > PID_MAX) {
-        //not doing anything
+        return;
     }
 
     sem = (sem_t *)pcb[active_pid].trapframe_p->ebx;
     if(*sem == SEMAPHORE_UNINITIALIZED){
-        //index to an arraay of semaphore and checking inti not equal to intialize so equal to -1
-        if(semaphores[*sem].init != SEMAPHORE_INITIALIZED){
-            queue_out(&semaphore_q, sem);
-            semaphores[*sem].count = 0;
-            semaphores[*sem].init = SEMAPHORE_INITIALIZED;
-            queue_init(&semaphores[*sem].wait_q);
+        // Allocate a semaphore from the semaphore queue
+        if(queue_out(&semaphore_q, &id) != 0){
+            panic_warn("No semaphores available\n");
+            return;
         }
+        semaphores[id].count = 0;
+        semaphores[id].holder = -1;
+        semaphores[id].init = SEMAPHORE_INITIALIZED;
+        plist_init(&semaphores[id].wait_q);
+        *sem = id;
     }
-    else if (semaphores[*sem].init == SEMAPHORE_INITIALIZED){
+    else if (ksem_valid(*sem) && semaphores[*sem].holder == -1){
+        // Only reset a semaphore that nobody holds
         semaphores[*sem].count = 0;
     }
 
@@ -129,161 +533,952 @@ void ksyscall_sem_init(){
 // For the passed in semaphore, determine if the semaphore id is valid. If it is not valid, panic.
 // If the semaphore count is > 0, then it means that at least one process is already waiting. In this case, the process should be unscheduled and moved into the wait queue for the given semaphore. The process state should be WAITING in this case.
 // The semaphore count should be incremented whenever a call to sem_wait is performed.
+// A process that blocks lends its priority to the holder of the semaphore (and
+// along the chain of holders that are themselves blocked) so that a lower
+// priority holder cannot stall it indefinitely.
 void ksyscall_sem_wait(){
     sem_t *sem;
+
     // Don't do anything if the running PID is invalid
     if (active_pid < 0 || active_pid > PID_MAX) {
-        //not doing anything
+        return;
     }
 
     sem = (sem_t *)pcb[active_pid].trapframe_p->ebx;
-    if(semaphores[*sem].count > 0 && pcb[active_pid].state == ACTIVE){
-        queue_out(&semaphore_q, sem);
-        queue_in(&semaphores[*sem].wait_q, *sem);
-        pcb[active_pid].state = WAITING;
+    if(!ksem_valid(*sem)){
+        panic("Invalid semaphore\n");
     }
+
     semaphores[*sem].count++;
-    
+
+    if(semaphores[*sem].holder == -1){
+        // The semaphore is free, take it
+        semaphores[*sem].holder = active_pid;
+        return;
+    }
+
+    // Block until the semaphore is handed over by sem_post
+    plist_in(&semaphores[*sem].wait_q, active_pid);
+    pcb[active_pid].state = WAITING;
+    pcb[active_pid].blocked_on = *sem;
+
+    ksem_inherit(active_pid, *sem);
+
+    active_pid = -1;
 }
+
 // Posts a semaphore and releases the first process that was waiting on the semaphore.
 // For the passed in semaphore, determine if the semaphore id is valid. If it is not valid, panic.
 // If the semaphore has a process that is waiting, move the process from the semaphore wait queue to the kernel run queue. Ensure that when this happens, the process state is set to RUNNING.
 // If the semaphore count is > 0, it should be decremented.
-
+// The semaphore is handed directly to the released process and any priority
+// the poster inherited through this semaphore is given up.
 void ksyscall_sem_post(){
-    
     sem_t *sem;
-    
+
     // Don't do anything if the running PID is invalid
     if (active_pid < 0 || active_pid > PID_MAX) {
-        //not doing anything
+        return;
     }
+
     sem = (sem_t *)pcb[active_pid].trapframe_p->ebx;
-    if(semaphores[*sem].count > 0 && pcb[active_pid].state == ACTIVE){
-        queue_out(&semaphore_q, sem);
-        queue_in(&run_q, *sem);
-        pcb[active_pid].state = RUNNING;
-        semaphores[*sem].count--;
+    if(!ksem_valid(*sem)){
+        panic("Invalid semaphore\n");
     }
-    
-    
-}
-
-// Sends a message to the specified mailbox. This is a non-blocking operation. The calling process will proceed once the message is "sent" to the mailbox.
-// A message is sent by queuing it into the specified mailbox.
-// If the mailbox is full (message queue is full) the system call handler should panic.
-// If the mailbox has a process in it's wait queue, it should:
-// Queue out from the mailbox wait queue and move the process to the kernel run queue
-// Ensure that the state is set to RUNNING
-// Obtain the message pointer from the receiving process' trapframe
-// Queue out the message from the mailbox to the receiving process
 
-void ksyscall_msg_send(){
-    msg_t *msg;
-    int mbox_num;
-    int pid;
-    // Don't do anything if the running PID is invalid
-    if (active_pid < 0 || active_pid > PID_MAX) {
-        //not doing anything
+    if(semaphores[*sem].holder != active_pid){
+        panic_warn("Semaphore posted by a process that does not hold it\n");
+        return;
     }
 
-    //from the trapframe 
-    msg = (msg_t *)pcb[active_pid].trapframe_p->ebx;
-    mbox_num = pcb[active_pid].trapframe_p->ecx;
+    ksem_release(*sem);
 
-    //mailbox if full
-    if(mailboxes[mbox_num].size == MBOX_SIZE){
-        panic("message box is at its capacity");
+    // Drop any priority inherited through this semaphore
+    ksem_restore(active_pid);
+}
+
+/**
+ * Hands a semaphore to the next process waiting on it, or frees it and
+ * wakes anyone selecting on it if there are no waiters
+ * @param id - the semaphore id
+ */
+void ksem_release(int id) {
+    int pid;
+
+    if(semaphores[id].count > 0){
+        semaphores[id].count--;
     }
 
-    if(mailboxes[mbox_num].wait_q.size > 0){
-        queue_out(&(mailboxes[mbox_num].wait_q), &pid);
-        queue_in(&run_q, pid);
-        pcb[pid].state = RUNNING;
-        sp_memcpy(((msg_t *)pcb[pid].trapframe_p->ebx), &msg, sizeof(msg));
+    if(plist_out(&semaphores[id].wait_q, &pid) == 0){
+        semaphores[id].holder = pid;
+        pcb[pid].blocked_on = -1;
+        pcb[pid].trapframe_p->ebx = 0;
+        ktimer_remove(pid);
+        kproc_enqueue(pid);
+
+        // The new holder may have waiters that outrank it
+        ksem_restore(pid);
     }
     else{
-        mbox_enqueue(msg, mbox_num);
+        semaphores[id].holder = -1;
+
+        // The semaphore is free; wake anyone selecting on it
+        if(semaphores[id].select_count > 0){
+            kselect_notify(semaphores[id].select_pids);
+        }
     }
-    
 }
 
-// Receives a message from the specified mailbox. This is a blocking operation - if the mailbox is empty, the process will not proceed - it should wait. If the mailbox has a message, it can be "received" immediately and the calling process can proceed.
-// If the mailbox has a message
-// Dequeue it to the message pointer via the running process' trapframe
-// Panic if a message cannot be dequeued
-// If there is no message in the mailbox
-// Move the process to the specified mailbox wait queue
-// Set the state to WAITING
-// Clear the run pid so another process can be scheduled
-void ksyscall_msg_recv(){
-    msg_t *msg;
-    int mbox_num;
+/**
+ * Undoes the semaphore wait of a process that stopped waiting without
+ * being handed the semaphore, after it was removed from the wait queue
+ * The holder no longer inherits the process' priority
+ * @param pid - the process id
+ */
+void ksem_cancel(int pid) {
+    int id;
 
-    // Don't do anything if the running PID is invalid
-    if (active_pid < 0 || active_pid > PID_MAX) {
-        //not doing anything
+    id = pcb[pid].blocked_on;
+    if (id < 0) {
+        return;
     }
-    msg = (msg_t *)pcb[active_pid].trapframe_p->ebx;
-    mbox_num = pcb[active_pid].trapframe_p->ecx;
 
-    if(mailboxes[mbox_num].size == 0){
-        queue_in(&(mailboxes[mbox_num].wait_q), active_pid);
-        pcb[active_pid].state = WAITING;
-        active_pid = -1;
+    semaphores[id].count--;
+    pcb[pid].blocked_on = -1;
+
+    if (semaphores[id].holder >= 0) {
+        ksem_restore(semaphores[id].holder);
     }
-    else{
-        mbox_dequeue(msg, mbox_num);
+}
+
+/**
+ * Releases every semaphore held by a process, as done when it exits
+ * @param pid - the process id
+ */
+void ksem_release_all(int pid) {
+    int id;
+
+    for (id = 0; id < SEMAPHORE_MAX; id++) {
+        if (semaphores[id].holder == pid) {
+            ksem_release(id);
+        }
+    }
+}
+
+/**
+ * System call kernel handler: sem_timedwait
+ * Waits on the semaphore pointed to by EBX for at most ECX milliseconds
+ * (IPC_FOREVER to wait indefinitely, 0 to not wait at all)
+ * Returns 0 once the semaphore is taken, IPC_TIMEOUT if the deadline passed
+ * first, or -1 on error, in EBX
+ */
+void ksyscall_sem_timedwait(){
+    sem_t *sem;
+    int timeout;
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    sem = (sem_t *)pcb[active_pid].trapframe_p->ebx;
+    timeout = pcb[active_pid].trapframe_p->ecx;
+
+    if(!ksem_valid(*sem)){
+        pcb[active_pid].trapframe_p->ebx = -1;
+        return;
     }
 
+    if(semaphores[*sem].holder == -1){
+        // The semaphore is free, take it
+        semaphores[*sem].count++;
+        semaphores[*sem].holder = active_pid;
+        pcb[active_pid].trapframe_p->ebx = 0;
+        return;
+    }
+
+    if(timeout == 0){
+        pcb[active_pid].trapframe_p->ebx = IPC_TIMEOUT;
+        return;
+    }
+
+    // Block until the semaphore is handed over by sem_post or the timer
+    // expires
+    semaphores[*sem].count++;
+    plist_in(&semaphores[*sem].wait_q, active_pid);
+    pcb[active_pid].state = WAITING;
+    pcb[active_pid].blocked_on = *sem;
+
+    ksem_inherit(active_pid, *sem);
+
+    if(timeout > 0){
+        ktimer_add(active_pid, system_time + TIMER_MS_TICKS(timeout));
+    }
+
+    active_pid = -1;
 }
 
+// Sends a message to the specified mailbox. This is a non-blocking operation. The calling process will proceed once the message is "sent" to the mailbox.
+// A message is sent by queuing its header and size data bytes into the specified mailbox.
+// If the mailbox is full (message ring is full) the system call handler should panic.
+// If the mailbox has a process in it's wait queue, it should:
+// Queue out from the mailbox wait queue and move the process to the kernel run queue
+// Ensure that the state is set to RUNNING
+// Copy the message straight to the receiving process' message pointer
 
-// The mailbox enqueue function will behave similar to your normal queue, except that it will use an array of messages versus an array of integers for the items within your queue.
-// When enqueueing an item, you should copy the message to the specified mailbox message using the source message pointer.
-int mbox_enqueue(msg_t *msg, int mbox_num){
+void ksyscall_msg_send(){
+    msg_t *msg;
+    int mbox_num;
+    mailbox_t *mbox;
 
-    sp_memcpy(&(mailboxes[mbox_num].messages[mailboxes[mbox_num].tail]), &msg, sizeof(msg));
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
 
-    mailboxes[mbox_num].tail++;
+    //from the trapframe 
+    msg = (msg_t *)pcb[active_pid].trapframe_p->ebx;
+    mbox_num = pcb[active_pid].trapframe_p->ecx;
+
+    mbox = kmbox_get(mbox_num);
+    if (mbox == NULL) {
+        panic_warn("Invalid mailbox");
+        return;
+    }
+
+    if (msg->size < 0 || msg->size > MSG_SIZE_MAX) {
+        panic_warn("Invalid message size");
+        return;
+    }
+
+    //mailbox if full
+    if(mbox->wait_q.size == 0 && mbox_full(mbox_num, msg->size)){
+        panic("message box is at its capacity");
+    }
+
+    if(kmbox_send(mbox, mbox_num, msg) != 0){
+        panic_warn("Unable to allocate message");
+    }
+}
+
+/**
+ * Sends one message from the active process to a mailbox
+ * The message is handed straight to a waiting receiver if there is one,
+ * otherwise it is queued; the size must already be validated
+ * @param  mbox     - the mailbox
+ * @param  mbox_num - the mailbox number
+ * @param  msg      - the message, in the active process' address space
+ * @return 0 on success; -1 if the mailbox is full or memory is exhausted
+ */
+int kmbox_send(mailbox_t *mbox, int mbox_num, msg_t *msg) {
+    mbox_hdr_t hdr;
+    int pid;
+
+    // The kernel stamps the sender and time
+    hdr.sender = active_pid;
+    hdr.time_sent = system_time/100;
+    hdr.time_received = 0;
+    hdr.size = msg->size;
+
+    if(mbox->wait_q.size > 0){
+        // Hand the message straight to the waiting receiver
+        plist_out(&mbox->wait_q, &pid);
+        ktimer_remove(pid);
+        kproc_enqueue(pid);
+        kmbox_deliver(pid, &hdr, msg->data);
+        return 0;
+    }
+
+    if(mbox_full(mbox_num, hdr.size)){
+        return -1;
+    }
+
+    if(mbox_enqueue(&hdr, msg->data, mbox_num) != 0){
+        return -1;
+    }
 
-    if(mailboxes[mbox_num].tail == MBOX_SIZE){
-        mailboxes[mbox_num].tail = 0;
+    // The mailbox has a message; wake anyone selecting on it
+    if(mbox->select_count > 0){
+        kselect_notify(mbox->select_pids);
     }
 
-    mailboxes[mbox_num].size++;
     return 0;
+}
+
+// Receives a message from the specified mailbox. This is a blocking operation - if the mailbox is empty, the process will not proceed - it should wait. If the mailbox has a message, it can be "received" immediately and the calling process can proceed.
+// If the mailbox has a message
+// Dequeue it to the message pointer via the running process' trapframe
+// Panic if a message cannot be dequeued
+// If there is no message in the mailbox
+// Move the process to the specified mailbox wait queue
+// Set the state to WAITING
+// Clear the run pid so another process can be scheduled
+void ksyscall_msg_recv(){
+    int mbox_num;
+    mailbox_t *mbox;
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+    mbox_num = pcb[active_pid].trapframe_p->ecx;
+
+    mbox = kmbox_get(mbox_num);
+    if (mbox == NULL) {
+        panic_warn("Invalid mailbox");
+        return;
+    }
 
+    if(mbox_empty(mbox_num)){
+        plist_in(&mbox->wait_q, active_pid);
+        pcb[active_pid].state = WAITING;
+        active_pid = -1;
+    }
+    else if(mbox_dequeue((msg_t *)pcb[active_pid].trapframe_p->ebx,
+                         pcb[active_pid].trapframe_p->edx, mbox_num) != 0){
+        panic("Unable to dequeue message");
+    }
 }
 
-// The mailbox enqueue function will behave similar to your normal queue, except that it will use an array of messages versus an array of integers for the items within your queue.
-// When dequeuing an item, you should copy the message from the specified mailbox message using the destination message pointer.
-int mbox_dequeue(msg_t *msg, int mbox_num){
-    
-    sp_memcpy(&msg, &(mailboxes[mbox_num].messages[mailboxes[mbox_num].head]), sizeof(mailboxes[mbox_num].messages[mailboxes[mbox_num].head]));
+/**
+ * System call kernel handler: msg_recv_timeout
+ * Receives a message from the mailbox in ECX into the message at the
+ * address in EBX (EDX data bytes), waiting at most ESI milliseconds
+ * (IPC_FOREVER to wait indefinitely, 0 to not wait at all)
+ * Returns 1 if a message was received, 0 if the mailbox was empty and the
+ * call did not wait, IPC_TIMEOUT if the deadline passed first, or -1 on
+ * error, in EBX
+ */
+void ksyscall_msg_recv_timeout() {
+    int mbox_num;
+    int timeout;
+    mailbox_t *mbox;
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
 
-    //moving the head
-    mailboxes[mbox_num].head++;
+    mbox_num = pcb[active_pid].trapframe_p->ecx;
+    timeout  = pcb[active_pid].trapframe_p->esi;
+
+    mbox = kmbox_get(mbox_num);
+    if (mbox == NULL) {
+        pcb[active_pid].trapframe_p->ebx = -1;
+        return;
+    }
+
+    if (!mbox_empty(mbox_num)) {
+        mbox_dequeue((msg_t *)pcb[active_pid].trapframe_p->ebx,
+                     pcb[active_pid].trapframe_p->edx, mbox_num);
+        pcb[active_pid].trapframe_p->ebx = 1;
+        return;
+    }
 
-    if(mailboxes[mbox_num].head == MBOX_SIZE){
-        mailboxes[mbox_num].head = 0;
+    if (timeout == 0) {
+        pcb[active_pid].trapframe_p->ebx = 0;
+        return;
     }
 
-    mailboxes[mbox_num].size--;
+    // Wait for a sender to deliver the message or the timer to expire
+    plist_in(&mbox->wait_q, active_pid);
+    pcb[active_pid].state = WAITING;
+
+    if (timeout > 0) {
+        ktimer_add(active_pid, system_time + TIMER_MS_TICKS(timeout));
+    }
+
+    active_pid = -1;
+}
+
+/**
+ * Finds which of a set of mailboxes and semaphores are ready
+ * A mailbox is ready when it has a queued message and a semaphore is ready
+ * when it is free
+ * @param  set   - mailboxes and semaphores to check
+ * @param  ready - receives the ready ones
+ * @return number of ready mailboxes and semaphores
+ */
+int kselect_ready(ipc_set_t *set, ipc_set_t *ready) {
+    unsigned int mask;
+    int count = 0;
+    int w;
+    int i;
+
+    sp_memset(ready, 0, sizeof(ipc_set_t));
+
+    for (w = 0; w < IPC_SET_WORDS; w++) {
+        for (mask = set->mbox[w]; mask != 0; mask &= mask - 1) {
+            i = w * 32 + bit_first_set(mask);
+            if (mailboxes[i] != NULL && mailboxes[i]->count > 0) {
+                IPC_SET_ADD(ready->mbox, i);
+                count++;
+            }
+        }
+
+        for (mask = set->sem[w]; mask != 0; mask &= mask - 1) {
+            i = w * 32 + bit_first_set(mask);
+            if (semaphores[i].holder == -1) {
+                IPC_SET_ADD(ready->sem, i);
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Adds a process to the waiters of every mailbox and semaphore it selected
+ * @param pid - the process id
+ */
+void kselect_register(int pid) {
+    unsigned int mask;
+    int w;
+    int i;
+
+    for (w = 0; w < IPC_SET_WORDS; w++) {
+        for (mask = pcb[pid].select.mbox[w]; mask != 0; mask &= mask - 1) {
+            i = w * 32 + bit_first_set(mask);
+            IPC_SET_ADD(mailboxes[i]->select_pids, pid);
+            mailboxes[i]->select_count++;
+        }
+
+        for (mask = pcb[pid].select.sem[w]; mask != 0; mask &= mask - 1) {
+            i = w * 32 + bit_first_set(mask);
+            IPC_SET_ADD(semaphores[i].select_pids, pid);
+            semaphores[i].select_count++;
+        }
+    }
+}
+
+/**
+ * Removes a process from every mailbox and semaphore it is selecting on
+ * @param pid - the process id
+ */
+void kselect_unregister(int pid) {
+    unsigned int mask;
+    int w;
+    int i;
+
+    for (w = 0; w < IPC_SET_WORDS; w++) {
+        for (mask = pcb[pid].select.mbox[w]; mask != 0; mask &= mask - 1) {
+            i = w * 32 + bit_first_set(mask);
+            IPC_SET_DEL(mailboxes[i]->select_pids, pid);
+            mailboxes[i]->select_count--;
+        }
+
+        for (mask = pcb[pid].select.sem[w]; mask != 0; mask &= mask - 1) {
+            i = w * 32 + bit_first_set(mask);
+            IPC_SET_DEL(semaphores[i].select_pids, pid);
+            semaphores[i].select_count--;
+        }
+    }
+
+    sp_memset(&pcb[pid].select, 0, sizeof(ipc_set_t));
+}
+
+/**
+ * Wakes one process waiting in msg_select once something it selected is
+ * ready, completing its msg_select call
+ * A message or a free semaphore can only be taken by one process, so each
+ * event wakes a single selector; the rest stay registered
+ * @param pids - set of the processes selecting on what became ready; must
+ *               not be empty
+ */
+void kselect_notify(unsigned int *pids) {
+    ipc_set_t ready;
+    int pid;
+    int w;
+
+    for (w = 0; pids[w] == 0; w++) {
+        // Find the first word with a waiter
+    }
+    pid = w * 32 + bit_first_set(pids[w]);
+
+    // The process' set is still at the address in EBX
+    pcb[pid].trapframe_p->ebx = kselect_ready(&pcb[pid].select, &ready);
+    kpage_copy_to(pid, (ipc_set_t *)pcb[pid].trapframe_p->ebx, &ready, sizeof(ipc_set_t));
+
+    kselect_unregister(pid);
+    ktimer_remove(pid);
+    kproc_enqueue(pid);
+}
+
+/**
+ * System call kernel handler: msg_select
+ * Waits at most ECX milliseconds (IPC_FOREVER to wait indefinitely, 0 to
+ * not wait at all) until one of the mailboxes in the set at the address in
+ * EBX has a message or one of its semaphores is free
+ * Returns the number ready, 0 if none were and the call did not wait,
+ * IPC_TIMEOUT if the deadline passed first, or -1 on error, in EBX; the
+ * set is replaced with the ready mailboxes and semaphores when any are
+ */
+void ksyscall_msg_select() {
+    ipc_set_t *user_set;
+    ipc_set_t set;
+    ipc_set_t ready;
+    unsigned int mask;
+    int timeout;
+    int count;
+    int w;
+    int i;
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    user_set = (ipc_set_t *)pcb[active_pid].trapframe_p->ebx;
+    timeout  = pcb[active_pid].trapframe_p->ecx;
+    pcb[active_pid].trapframe_p->ebx = -1;
+
+    sp_memcpy(&set, user_set, sizeof(ipc_set_t));
+
+    // Every selected mailbox must exist so a sender can find the waiter
+    count = 0;
+    for (w = 0; w < IPC_SET_WORDS; w++) {
+        for (mask = set.mbox[w]; mask != 0; mask &= mask - 1) {
+            i = w * 32 + bit_first_set(mask);
+            if (i >= MBOX_MAX || kmbox_get(i) == NULL) {
+                return;
+            }
+            count++;
+        }
+
+        for (mask = set.sem[w]; mask != 0; mask &= mask - 1) {
+            i = w * 32 + bit_first_set(mask);
+            if (i >= SEMAPHORE_MAX || !ksem_valid(i)) {
+                return;
+            }
+            count++;
+        }
+    }
+
+    if (count == 0) {
+        return;
+    }
+
+    count = kselect_ready(&set, &ready);
+    if (count > 0 || timeout == 0) {
+        if (count > 0) {
+            sp_memcpy(user_set, &ready, sizeof(ipc_set_t));
+        }
+        pcb[active_pid].trapframe_p->ebx = count;
+        return;
+    }
+
+    // Register with every selected mailbox and semaphore; the first one to
+    // become ready wakes the process
+    pcb[active_pid].trapframe_p->ebx = (unsigned int)user_set;
+    sp_memcpy(&pcb[active_pid].select, &set, sizeof(ipc_set_t));
+    kselect_register(active_pid);
+
+    pcb[active_pid].state = WAITING;
+
+    if (timeout > 0) {
+        ktimer_add(active_pid, system_time + TIMER_MS_TICKS(timeout));
+    }
+
+    active_pid = -1;
+}
+
+/**
+ * System call kernel handler: msg_sendv
+ * Sends the array of messages at the address in EBX (EDX messages) to the
+ * mailbox in ECX, stopping at the first one that is invalid or does not fit
+ * Returns the number of messages sent in EBX
+ */
+void ksyscall_msg_sendv() {
+    msg_t *msgs;
+    int count;
+    int mbox_num;
+    int sent;
+    mailbox_t *mbox;
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    msgs     = (msg_t *)pcb[active_pid].trapframe_p->ebx;
+    mbox_num = pcb[active_pid].trapframe_p->ecx;
+    count    = pcb[active_pid].trapframe_p->edx;
+    pcb[active_pid].trapframe_p->ebx = 0;
+
+    mbox = kmbox_get(mbox_num);
+    if (mbox == NULL) {
+        return;
+    }
+
+    for (sent = 0; sent < count && sent < MSG_BATCH_MAX; sent++) {
+        if (msgs[sent].size < 0 || msgs[sent].size > MSG_SIZE) {
+            break;
+        }
+
+        if (kmbox_send(mbox, mbox_num, &msgs[sent]) != 0) {
+            break;
+        }
+    }
+
+    pcb[active_pid].trapframe_p->ebx = sent;
+}
+
+/**
+ * System call kernel handler: msg_recvv
+ * Receives up to ESI messages from the mailbox in ECX into the array of
+ * messages at the address in EBX. If the mailbox is empty the process waits
+ * for one message, unless MSG_NOWAIT is set in EDI
+ * Returns the number of messages received in EBX
+ */
+void ksyscall_msg_recvv() {
+    msg_t *msgs;
+    int mbox_num;
+    int max;
+    int received;
+    mailbox_t *mbox;
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    msgs     = (msg_t *)pcb[active_pid].trapframe_p->ebx;
+    mbox_num = pcb[active_pid].trapframe_p->ecx;
+    max      = pcb[active_pid].trapframe_p->esi;
+    mbox     = kmbox_get(mbox_num);
+
+    if (mbox == NULL || max <= 0) {
+        pcb[active_pid].trapframe_p->ebx = 0;
+        return;
+    }
+
+    if (mbox->count == 0) {
+        pcb[active_pid].trapframe_p->ebx = 0;
+
+        if (!(pcb[active_pid].trapframe_p->edi & MSG_NOWAIT)) {
+            // A sender delivers to msgs[0] and sets the count
+            plist_in(&mbox->wait_q, active_pid);
+            pcb[active_pid].state = WAITING;
+            active_pid = -1;
+        }
+        return;
+    }
+
+    if (max > MSG_BATCH_MAX) {
+        max = MSG_BATCH_MAX;
+    }
+
+    for (received = 0; received < max; received++) {
+        if (mbox_dequeue(&msgs[received], MSG_SIZE, mbox_num) != 0) {
+            break;
+        }
+    }
+
+    pcb[active_pid].trapframe_p->ebx = received;
+}
+
+/**
+ * Copies a message into a receiving process and completes its msg_recv or
+ * msg_recvv call, returning a count of one message in EBX
+ * The receiver's buffer size is in EDX of its trapframe; data past it is
+ * dropped, and the size field still reports the full message size
+ * @param pid  - the receiving process id
+ * @param hdr  - the message header; time_received is stamped here
+ * @param data - the message data, visible in the current address space
+ */
+void kmbox_deliver(int pid, mbox_hdr_t *hdr, unsigned char *data) {
+    msg_t *msg;
+    int len;
+
+    msg = (msg_t *)pcb[pid].trapframe_p->ebx;
+    len = hdr->size;
+    if (len > (int)pcb[pid].trapframe_p->edx) {
+        len = pcb[pid].trapframe_p->edx;
+    }
+
+    hdr->time_received = system_time/100;
+
+    kpage_copy_to(pid, msg, hdr, sizeof(mbox_hdr_t));
+    if (len > 0) {
+        kpage_copy_to(pid, msg->data, data, len);
+    }
+
+    pcb[pid].trapframe_p->ebx = 1;
+}
+
+/**
+ * System call kernel handler: msg_send_pages
+ * Loans the heap pages at the address in EBX (ECX pages) to the mailbox in
+ * EDX; the pages are unmapped from the sender rather than copied
+ * Returns 0 on success, -1 on error, in EBX
+ */
+void ksyscall_msg_send_pages() {
+    unsigned int addr;
+    int pages;
+    int pid;
+    mailbox_t *mbox;
+    msg_pages_t *loan;
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    addr  = pcb[active_pid].trapframe_p->ebx;
+    pages = pcb[active_pid].trapframe_p->ecx;
+    mbox  = kmbox_get(pcb[active_pid].trapframe_p->edx);
+    pcb[active_pid].trapframe_p->ebx = -1;
+
+    if (mbox == NULL || pages <= 0 || pages > MSG_PAGES_MAX) {
+        return;
+    }
+
+    if (mbox->loan_wait_q.size == 0 && mbox_page_ring_full(&mbox->loans)) {
+        return;
+    }
+
+    loan = kmalloc(sizeof(msg_pages_t) + (pages - 1) * sizeof(unsigned int));
+    if (loan == NULL) {
+        return;
+    }
+
+    if (kpage_loan(active_pid, addr, pages, loan->frames) != 0) {
+        kfree(loan);
+        return;
+    }
+
+    loan->sender = active_pid;
+    loan->pages = pages;
+
+    if (mbox->loan_wait_q.size > 0) {
+        // Hand the pages straight to the waiting receiver
+        plist_out(&mbox->loan_wait_q, &pid);
+        kmbox_deliver_pages(pid, loan);
+        kproc_enqueue(pid);
+    } else {
+        mbox_page_ring_put(&mbox->loans, &loan);
+    }
+
+    pcb[active_pid].trapframe_p->ebx = 0;
+}
+
+/**
+ * System call kernel handler: msg_recv_pages
+ * Receives loaned pages from the mailbox in EBX, waiting if there are none
+ * Returns the address the pages were mapped at, or 0 on error, in EBX and
+ * the number of pages in ECX
+ */
+void ksyscall_msg_recv_pages() {
+    mailbox_t *mbox;
+    msg_pages_t *loan;
+
+    // Don't do anything if the running PID is invalid
+    if (active_pid < 0 || active_pid > PID_MAX) {
+        return;
+    }
+
+    mbox = kmbox_get(pcb[active_pid].trapframe_p->ebx);
+    if (mbox == NULL) {
+        pcb[active_pid].trapframe_p->ebx = 0;
+        pcb[active_pid].trapframe_p->ecx = 0;
+        return;
+    }
+
+    if (mbox_page_ring_get(&mbox->loans, &loan) != 0) {
+        plist_in(&mbox->loan_wait_q, active_pid);
+        pcb[active_pid].state = WAITING;
+        active_pid = -1;
+        return;
+    }
+
+    kmbox_deliver_pages(active_pid, loan);
+}
+
+/**
+ * Maps loaned pages into a receiving process and completes its
+ * msg_recv_pages call
+ * If the receiver's heap cannot hold them the pages are freed
+ * @param pid  - the receiving process id
+ * @param loan - the loaned pages; freed by this function
+ */
+void kmbox_deliver_pages(int pid, msg_pages_t *loan) {
+    unsigned int addr;
+    int i;
+
+    addr = kpage_adopt(pid, loan->frames, loan->pages);
+
+    if (addr == 0) {
+        for (i = 0; i < loan->pages; i++) {
+            kmem_page_free((void *)loan->frames[i], 1);
+        }
+    }
+
+    pcb[pid].trapframe_p->ebx = addr;
+    pcb[pid].trapframe_p->ecx = addr != 0 ? loan->pages : 0;
+
+    kfree(loan);
+}
+
+/**
+ * Obtains a mailbox, creating it on first use
+ * @param  mbox_num - the mailbox number
+ * @return the mailbox; NULL if the number is invalid or memory is exhausted
+ */
+mailbox_t *kmbox_get(int mbox_num) {
+    mailbox_t *mbox;
+
+    if (mbox_num < 0 || mbox_num >= MBOX_MAX) {
+        return NULL;
+    }
+
+    mbox = mailboxes[mbox_num];
+    if (mbox == NULL) {
+        mbox = kslab_alloc(&mbox_cache);
+        if (mbox == NULL) {
+            return NULL;
+        }
+
+        mbox->buf = NULL;
+        mbox->bytes = 0;
+        mbox->head = 0;
+        mbox->tail = 0;
+        mbox->count = 0;
+        sp_memset(mbox->select_pids, 0, sizeof(mbox->select_pids));
+        mbox->select_count = 0;
+        plist_init(&mbox->wait_q);
+        mbox_page_ring_init(&mbox->loans);
+        plist_init(&mbox->loan_wait_q);
+        mailboxes[mbox_num] = mbox;
+    }
+
+    return mbox;
+}
+
+/**
+ * Copies bytes into or out of a mailbox's message ring, wrapping around
+ * the end of the ring
+ * @param mbox - the mailbox
+ * @param pos  - ring position (a head or tail count)
+ * @param buf  - the bytes to copy in, or the buffer to copy out to
+ * @param len  - number of bytes
+ * @param in   - nonzero to copy into the ring
+ */
+void mbox_copy(mailbox_t *mbox, unsigned int pos, void *buf, int len, int in) {
+    unsigned int offset;
+    int n;
+
+    offset = pos & (mbox->bytes - 1);
+    n = mbox->bytes - offset;
+    if (n > len) {
+        n = len;
+    }
+
+    // The part past the end of the ring continues at its start
+    if (in) {
+        sp_memcpy(mbox->buf + offset, buf, n);
+        if (len > n) {
+            sp_memcpy(mbox->buf, (char *)buf + n, len - n);
+        }
+    } else {
+        sp_memcpy(buf, mbox->buf + offset, n);
+        if (len > n) {
+            sp_memcpy((char *)buf + n, mbox->buf, len - n);
+        }
+    }
+}
+
+/**
+ * Grows a mailbox's message ring so it has room for at least len more bytes
+ * @param  mbox - the mailbox
+ * @param  len  - bytes needed
+ * @return 0 on success; -1 if memory is exhausted
+ */
+int mbox_grow(mailbox_t *mbox, unsigned int len) {
+    unsigned int used;
+    unsigned int bytes;
+    unsigned char *buf;
+
+    used = mbox->tail - mbox->head;
+    bytes = mbox->bytes > 0 ? mbox->bytes : MBOX_BYTES_MIN;
+    while (bytes - used < len) {
+        bytes *= 2;
+    }
+
+    if (bytes == mbox->bytes) {
+        return 0;
+    }
+
+    buf = kmalloc(bytes);
+    if (buf == NULL) {
+        return -1;
+    }
+
+    // Queued messages move to the start of the new ring
+    if (used > 0) {
+        mbox_copy(mbox, mbox->head, buf, used, 0);
+    }
+    kfree(mbox->buf);
+
+    mbox->buf = buf;
+    mbox->bytes = bytes;
+    mbox->head = 0;
+    mbox->tail = used;
 
     return 0;
 }
 
-int mbox_full(int mbox_num){
-    if(mailboxes[mbox_num].size == MBOX_SIZE){
-        return 1;
+// The mailbox enqueue function will behave similar to your normal queue, except that it stores bytes in a ring versus an array of integers for the items within your queue.
+// When enqueueing an item, you should copy the message header and its data into the ring.
+// The ring is grown as needed; mbox_full must be checked first.
+int mbox_enqueue(mbox_hdr_t *hdr, unsigned char *data, int mbox_num){
+    mailbox_t *mbox = mailboxes[mbox_num];
+
+    if (mbox_grow(mbox, sizeof(mbox_hdr_t) + hdr->size) != 0) {
+        return -1;
     }
+
+    mbox_copy(mbox, mbox->tail, hdr, sizeof(mbox_hdr_t), 1);
+    mbox_copy(mbox, mbox->tail + sizeof(mbox_hdr_t), data, hdr->size, 1);
+    mbox->tail += sizeof(mbox_hdr_t) + hdr->size;
+    mbox->count++;
+
     return 0;
 }
 
-int mbox_empty(int mbox_num){
-    if(mailboxes[mbox_num].size == 0){
-        return 1;
+// The mailbox dequeue function will behave similar to your normal queue, except that it stores bytes in a ring versus an array of integers for the items within your queue.
+// When dequeuing an item, you should copy the message header and at most size data bytes out of the ring to the destination message pointer.
+int mbox_dequeue(msg_t *msg, int size, int mbox_num){
+    mailbox_t *mbox = mailboxes[mbox_num];
+    mbox_hdr_t hdr;
+    int len;
+
+    if (mbox->count == 0) {
+        return -1;
+    }
+
+    mbox_copy(mbox, mbox->head, &hdr, sizeof(mbox_hdr_t), 0);
+
+    len = hdr.size < size ? hdr.size : size;
+
+    hdr.time_received = system_time/100;
+    sp_memcpy(msg, &hdr, sizeof(mbox_hdr_t));
+    if (len > 0) {
+        mbox_copy(mbox, mbox->head + sizeof(mbox_hdr_t), msg->data, len, 0);
     }
+
+    mbox->head += sizeof(mbox_hdr_t) + hdr.size;
+    mbox->count--;
+
     return 0;
-}
\ No newline at end of file
+}
+
+int mbox_full(int mbox_num, int size){
+    mailbox_t *mbox = mailboxes[mbox_num];
+
+    return MBOX_BYTES_MAX - (mbox->tail - mbox->head) < sizeof(mbox_hdr_t) + size;
+}
+
+int mbox_empty(int mbox_num){
+    return mailboxes[mbox_num]->count == 0;
+}
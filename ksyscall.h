@@ -3,10 +3,21 @@
 
 /* System information */
 void ksyscall_get_sys_time();
+void ksyscall_get_idle_stats();
+void ksyscall_get_mem_stats();
 
 /* Process information */
 void ksyscall_get_proc_pid();
 void ksyscall_get_proc_name();
+void ksyscall_set_proc_prio();
+void ksyscall_set_proc_quantum();
+void ksyscall_set_proc_nice();
+void ksyscall_sched_set_deadline();
+void ksyscall_sched_get_deadline_stats();
+void ksyscall_sched_yield_period();
+void ksyscall_get_stack_stats();
+void ksyscall_proc_sbrk();
+void ksyscall_proc_fork();
 
 /* Additional functionality */
 void ksyscall_sleep();
@@ -17,9 +28,27 @@ void ksyscall_proc_exit();
 void ksyscall_sem_init();
 void ksyscall_sem_wait();
 void ksyscall_sem_post();
+void ksyscall_sem_timedwait();
+void ksem_restore(int pid);
+int ksem_priority(int pid);
+void ksem_release(int id);
+void ksem_cancel(int pid);
+void ksem_release_all(int pid);
+
+/* Shared Memory */
+void ksyscall_shm_create();
+void ksyscall_shm_attach();
+void ksyscall_shm_detach();
 
 /* Message Passing */
 void ksyscall_msg_send();
 void ksyscall_msg_recv();
+void ksyscall_msg_sendv();
+void ksyscall_msg_recvv();
+void ksyscall_msg_recv_timeout();
+void ksyscall_msg_select();
+void kselect_unregister(int pid);
+void ksyscall_msg_send_pages();
+void ksyscall_msg_recv_pages();
 
 #endif
@@ -0,0 +1,303 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Kernel Timers
+ *
+ * Sleeping processes are kept in a hierarchical timing wheel. Level 0
+ * resolves single ticks, and each higher level resolves TIMER_WHEEL_SIZE
+ * times as many. Timers are inserted directly into the level that covers
+ * their distance from now and are cascaded down a level when the lower
+ * level wraps, so each tick only touches the timers that are expiring.
+ */
+#include "spede.h"
+#include "kernel.h"
+#include "kproc.h"
+#include "ktimer.h"
+
+// Head of the process list for every slot, TIMER_NONE when empty
+int timer_wheel[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SIZE];
+
+// Time up to which the wheel has been processed
+int timer_time;
+
+// Number of ticks the PIT one-shot was programmed for, 0 when periodic
+int timer_oneshot_ticks;
+
+// Timer statistics
+int timer_wakeups;
+int timer_late_ticks;
+int timer_late_max;
+int timer_ticks_taken;
+int timer_ticks_skipped;
+
+/**
+ * Loads a mode and count into PIT channel 0
+ * @param mode  - the PIT mode/command byte
+ * @param count - the 16-bit count
+ */
+void ktimer_pit_load(int mode, int count) {
+    outportb(PIT_COMMAND, mode);
+    outportb(PIT_CHANNEL0, count & 0xFF);
+    outportb(PIT_CHANNEL0, (count >> 8) & 0xFF);
+}
+
+/**
+ * Reads the current count of PIT channel 0
+ * @return counts left before the channel next reaches terminal count
+ */
+int ktimer_pit_read() {
+    int count;
+
+    outportb(PIT_COMMAND, PIT_LATCH);
+    count = inportb(PIT_CHANNEL0);
+    count |= inportb(PIT_CHANNEL0) << 8;
+
+    return count;
+}
+
+/**
+ * Finds the number of ticks until the wheel next has work to do
+ * Level boundaries are treated as work since they cascade timers
+ * @param  limit - maximum number of ticks to look ahead
+ * @return ticks until the next expiry or cascade, at most limit
+ */
+int ktimer_next_deadline(int limit) {
+    int n;
+    int t;
+
+    for (n = 1; n < limit; n++) {
+        t = timer_time + n;
+
+        if ((t & TIMER_WHEEL_MASK) == 0 || timer_wheel[0][t & TIMER_WHEEL_MASK] != TIMER_NONE) {
+            break;
+        }
+    }
+
+    return n;
+}
+
+/**
+ * Links a process into the wheel slot matching its wake time
+ * @param pid     - the process id
+ * @param cascade - nonzero when called by ktimer_cascade, before the
+ *                  level 0 slot of the current tick has been processed
+ */
+void ktimer_insert(int pid, int cascade) {
+    int expires;
+    int due;
+    int delta;
+    int level;
+    int *slot;
+
+    expires = pcb[pid].wake_time;
+
+    // Timers that are already due fire on the next tick, or on this tick
+    // while cascading since its level 0 slot is about to be processed
+    due = cascade ? timer_time : timer_time + 1;
+    if (expires < due) {
+        expires = due;
+    }
+
+    // Timers beyond the wheel are parked at its far end and re-cascaded
+    delta = expires - timer_time;
+    if (delta >= TIMER_WHEEL_SPAN) {
+        expires = timer_time + TIMER_WHEEL_SPAN - 1;
+        delta = TIMER_WHEEL_SPAN - 1;
+    }
+
+    // Find the lowest level whose range covers the distance
+    for (level = 0; level < TIMER_WHEEL_LEVELS - 1; level++) {
+        if (delta < (1 << (TIMER_WHEEL_BITS * (level + 1)))) {
+            break;
+        }
+    }
+
+    slot = &timer_wheel[level][(expires >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK];
+
+    // Push onto the head of the slot list
+    pcb[pid].timer_slot = slot;
+    pcb[pid].timer_prev = TIMER_NONE;
+    pcb[pid].timer_next = *slot;
+
+    if (*slot != TIMER_NONE) {
+        pcb[*slot].timer_prev = pid;
+    }
+
+    *slot = pid;
+}
+
+/**
+ * Re-inserts every timer from a slot of the specified level so it moves
+ * to a lower level
+ * @param level - the wheel level
+ * @param index - the slot index within the level
+ */
+void ktimer_cascade(int level, int index) {
+    int pid;
+    int next;
+
+    pid = timer_wheel[level][index];
+    timer_wheel[level][index] = TIMER_NONE;
+
+    while (pid != TIMER_NONE) {
+        next = pcb[pid].timer_next;
+        ktimer_insert(pid, 1);
+        pid = next;
+    }
+}
+
+/**
+ * Initializes the timer wheel
+ */
+void ktimer_init() {
+    int i;
+    int j;
+
+    for (i = 0; i < TIMER_WHEEL_LEVELS; i++) {
+        for (j = 0; j < TIMER_WHEEL_SIZE; j++) {
+            timer_wheel[i][j] = TIMER_NONE;
+        }
+    }
+
+    timer_time = system_time;
+    timer_oneshot_ticks = 0;
+    timer_wakeups = 0;
+    timer_late_ticks = 0;
+    timer_late_max = 0;
+    timer_ticks_taken = 0;
+    timer_ticks_skipped = 0;
+
+    // Start from a known periodic tick rate
+    ktimer_pit_load(PIT_MODE_PERIODIC, PIT_DIVISOR);
+}
+
+/**
+ * Reprograms the PIT in one-shot mode up to the next timer deadline
+ * Called when the idle task is the only process that can run
+ */
+void ktimer_idle_enter() {
+    int ticks;
+
+    if (!TIMER_TICKLESS || timer_oneshot_ticks > 0) {
+        return;
+    }
+
+    // The periodic tick is just as good when the deadline is the next tick
+    ticks = ktimer_next_deadline(TIMER_ONESHOT_MAX);
+    if (ticks <= 1) {
+        return;
+    }
+
+    // The idle task is usually entered part way through a tick, so the
+    // one-shot covers what is left of the current tick plus whole ticks
+    // and fires on the same boundary the periodic tick would have
+    ktimer_pit_load(PIT_MODE_ONESHOT, ktimer_pit_read() + (ticks - 1) * PIT_DIVISOR);
+    timer_oneshot_ticks = ticks;
+}
+
+/**
+ * Determines how many ticks have elapsed since the last timer interrupt
+ * and restores the periodic tick if the PIT was in one-shot mode
+ * @return number of elapsed ticks
+ */
+int ktimer_ticks_elapsed() {
+    int ticks;
+
+    timer_ticks_taken++;
+
+    if (timer_oneshot_ticks == 0) {
+        return 1;
+    }
+
+    ticks = timer_oneshot_ticks;
+    timer_oneshot_ticks = 0;
+    timer_ticks_skipped += ticks - 1;
+
+    ktimer_pit_load(PIT_MODE_PERIODIC, PIT_DIVISOR);
+
+    return ticks;
+}
+
+/**
+ * Arms a timer so the process is woken at the specified time
+ * @param pid       - the process id
+ * @param wake_time - system time at which the process should be woken
+ */
+void ktimer_add(int pid, int wake_time) {
+    pcb[pid].wake_time = wake_time;
+    ktimer_insert(pid, 0);
+}
+
+/**
+ * Disarms a timer for the specified process, if it has one
+ * @param pid - the process id
+ */
+void ktimer_remove(int pid) {
+    if (pcb[pid].timer_slot == NULL) {
+        return;
+    }
+
+    if (pcb[pid].timer_prev != TIMER_NONE) {
+        pcb[pcb[pid].timer_prev].timer_next = pcb[pid].timer_next;
+    } else {
+        *pcb[pid].timer_slot = pcb[pid].timer_next;
+    }
+
+    if (pcb[pid].timer_next != TIMER_NONE) {
+        pcb[pcb[pid].timer_next].timer_prev = pcb[pid].timer_prev;
+    }
+
+    pcb[pid].timer_slot = NULL;
+    pcb[pid].timer_next = TIMER_NONE;
+    pcb[pid].timer_prev = TIMER_NONE;
+}
+
+/**
+ * Advances the timer wheel up to the current system time and
+ * wakes up every process whose timer has expired; a process still waiting
+ * on a semaphore or mailbox has its wait timed out
+ */
+void ktimer_tick() {
+    int level;
+    int index;
+    int pid;
+    int late;
+
+    while (timer_time < system_time) {
+        timer_time++;
+
+        // Cascade higher levels whenever the level below wraps around
+        for (level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+            if ((timer_time & ((1 << (TIMER_WHEEL_BITS * level)) - 1)) != 0) {
+                break;
+            }
+            ktimer_cascade(level, (timer_time >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK);
+        }
+
+        // Everything left in the current level 0 slot expires now
+        index = timer_time & TIMER_WHEEL_MASK;
+
+        while ((pid = timer_wheel[0][index]) != TIMER_NONE) {
+            ktimer_remove(pid);
+
+            late = system_time - pcb[pid].wake_time;
+            if (late < 0) {
+                late = 0;
+            }
+
+            timer_wakeups++;
+            timer_late_ticks += late;
+            if (late > timer_late_max) {
+                timer_late_max = late;
+            }
+
+            if (pcb[pid].state == WAITING) {
+                kproc_timeout(pid);
+            } else {
+                kproc_enqueue(pid);
+            }
+        }
+    }
+}
@@ -0,0 +1,97 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Kernel Timers
+ */
+#ifndef KTIMER_H
+#define KTIMER_H
+
+// Number of bits of the wake time resolved by each wheel level
+#define TIMER_WHEEL_BITS 6
+
+// Number of slots in each wheel level
+#define TIMER_WHEEL_SIZE (1 << TIMER_WHEEL_BITS)
+
+// Mask to obtain a slot index within a level
+#define TIMER_WHEEL_MASK (TIMER_WHEEL_SIZE - 1)
+
+// Number of wheel levels
+#define TIMER_WHEEL_LEVELS 3
+
+// Number of ticks the wheel can represent before timers must be re-cascaded
+#define TIMER_WHEEL_SPAN (1 << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))
+
+// Value used to terminate timer slot lists
+#define TIMER_NONE -1
+
+// Enables dynamic ticks while only the idle task can run
+#ifndef TIMER_TICKLESS
+#define TIMER_TICKLESS 1
+#endif
+
+// Timer interrupts per second
+#define TIMER_HZ 100
+
+// Converts milliseconds to ticks, rounding up
+#define TIMER_MS_TICKS(ms) ((ms) / 1000 * TIMER_HZ + ((ms) % 1000 * TIMER_HZ + 999) / 1000)
+
+// 8253/8254 programmable interval timer
+#define PIT_FREQ 1193182                    // input clock frequency (Hz)
+#define PIT_DIVISOR (PIT_FREQ / TIMER_HZ)   // counts per tick
+#define PIT_CHANNEL0 0x40                   // channel 0 data port
+#define PIT_COMMAND 0x43                    // mode/command port
+#define PIT_MODE_ONESHOT 0x30               // channel 0, lo/hi byte, mode 0
+#define PIT_MODE_PERIODIC 0x34              // channel 0, lo/hi byte, mode 2
+#define PIT_LATCH 0x00                      // channel 0, latch count
+
+// Most ticks that fit in a single one-shot PIT count
+#define TIMER_ONESHOT_MAX (0xFFFF / PIT_DIVISOR)
+
+// Timer statistics
+extern int timer_wakeups;           // total number of expired timers
+extern int timer_late_ticks;        // sum of ticks that wakeups were late
+extern int timer_late_max;          // worst case wakeup lateness in ticks
+extern int timer_ticks_taken;       // ticks delivered by a timer interrupt
+extern int timer_ticks_skipped;     // ticks accounted for without an interrupt
+
+/**
+ * Initializes the timer wheel
+ */
+void ktimer_init();
+
+/**
+ * Arms a timer so the process is woken at the specified time
+ * @param pid       - the process id
+ * @param wake_time - system time at which the process should be woken
+ */
+void ktimer_add(int pid, int wake_time);
+
+/**
+ * Disarms a timer for the specified process, if it has one
+ * @param pid - the process id
+ */
+void ktimer_remove(int pid);
+
+/**
+ * Reprograms the PIT in one-shot mode up to the next timer deadline
+ * Called when the idle task is the only process that can run
+ */
+void ktimer_idle_enter();
+
+/**
+ * Determines how many ticks have elapsed since the last timer interrupt
+ * and restores the periodic tick if the PIT was in one-shot mode
+ * @return number of elapsed ticks
+ */
+int ktimer_ticks_elapsed();
+
+/**
+ * Advances the timer wheel up to the current system time and
+ * wakes up every process whose timer has expired; a process still waiting
+ * on a semaphore or mailbox has its wait timed out
+ */
+void ktimer_tick();
+
+#endif
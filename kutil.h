@@ -32,4 +32,17 @@ void panic(char *msg);
  */
 void panic_warn(char *msg);
 
+/**
+ * Finds the lowest set bit in a mask using a single bit scan
+ * @param  mask - bit mask; must be non-zero
+ * @return index of the lowest set bit
+ */
+static __inline__ int bit_first_set(unsigned int mask) {
+    int bit;
+
+    asm("bsfl %1, %0" : "=r" (bit) : "rm" (mask));
+
+    return bit;
+}
+
 #endif
@@ -41,10 +41,10 @@ char os_name[32];
     kproc_exec("ktask_idle", &ktask_idle, &idle_q);
 
     //Launch the dispatcher_proc
-    kproc_exec("dispatcher_proc", &dispatcher_proc, &run_q);
+    kproc_exec("dispatcher_proc", &dispatcher_proc, &run_q[PRIO_DEFAULT]);
 
     //Launch the printer_proc
-    kproc_exec("printer_proc", &printer_proc, &run_q);
+    kproc_exec("printer_proc", &printer_proc, &run_q[PRIO_DEFAULT]);
     kproc_schedule();
 
     // should never be reached
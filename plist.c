@@ -0,0 +1,106 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Process List Utilities
+ */
+
+#include "spede.h"
+#include "kernel.h"
+#include "plist.h"
+
+/**
+ * Initializes an empty process list
+ *
+ * @param  list - pointer to the list
+ * @return -1 on error; 0 on success
+ */
+int plist_init(plist_t *list) {
+    if (list == NULL) {
+        return -1;
+    }
+
+    list->head = PLIST_NONE;
+    list->tail = PLIST_NONE;
+    list->size = 0;
+
+    return 0;
+}
+
+/**
+ * Adds a process to the tail of a list
+ * @param  list - pointer to the list
+ * @param  pid  - the process to add
+ * @return -1 on error; 0 on success
+ */
+int plist_in(plist_t *list, int pid) {
+    // A process may only be on one list at a time
+    if (list == NULL || pcb[pid].queue != NULL) {
+        return -1;
+    }
+
+    pcb[pid].queue = list;
+    pcb[pid].list_next = PLIST_NONE;
+    pcb[pid].list_prev = list->tail;
+
+    if (list->tail != PLIST_NONE) {
+        pcb[list->tail].list_next = pid;
+    } else {
+        list->head = pid;
+    }
+
+    list->tail = pid;
+    list->size++;
+
+    return 0;
+}
+
+/**
+ * Pulls a process out from the head of the specified list
+ * @param  list - pointer to the list
+ * @param  pid  - pointer to where the process id is stored
+ * @return -1 on error; 0 on success
+ */
+int plist_out(plist_t *list, int *pid) {
+    if (list == NULL || list->size == 0) {
+        return -1;
+    }
+
+    *pid = list->head;
+
+    return plist_remove(*pid);
+}
+
+/**
+ * Removes a process from whichever list it is on
+ * @param  pid - the process to remove
+ * @return -1 if the process is not on a list; 0 on success
+ */
+int plist_remove(int pid) {
+    plist_t *list = pcb[pid].queue;
+
+    if (list == NULL) {
+        return -1;
+    }
+
+    if (pcb[pid].list_prev != PLIST_NONE) {
+        pcb[pcb[pid].list_prev].list_next = pcb[pid].list_next;
+    } else {
+        list->head = pcb[pid].list_next;
+    }
+
+    if (pcb[pid].list_next != PLIST_NONE) {
+        pcb[pcb[pid].list_next].list_prev = pcb[pid].list_prev;
+    } else {
+        list->tail = pcb[pid].list_prev;
+    }
+
+    list->size--;
+
+    pcb[pid].queue = NULL;
+    pcb[pid].list_next = PLIST_NONE;
+    pcb[pid].list_prev = PLIST_NONE;
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Process List Utilities
+ */
+#ifndef PLIST_H
+#define PLIST_H
+
+#include "global.h"
+
+// Value for an empty list link
+#define PLIST_NONE -1
+
+// Process list data structure
+// The links are stored in the process control block of each member, so a
+// process can be on at most one list at a time
+typedef struct plist_t {
+    int head;               // first process in the list
+    int tail;               // last process in the list
+    int size;               // number of processes in the list
+} plist_t;
+
+/**
+ * Function declarations
+ */
+
+/**
+ * Initializes an empty process list
+ *
+ * @param  list - pointer to the list
+ * @return -1 on error; 0 on success
+ */
+int plist_init(plist_t *list);
+
+/**
+ * Adds a process to the tail of a list
+ * @param  list - pointer to the list
+ * @param  pid  - the process to add
+ * @return -1 on error; 0 on success
+ */
+int plist_in(plist_t *list, int pid);
+
+/**
+ * Pulls a process out from the head of the specified list
+ * @param  list - pointer to the list
+ * @param  pid  - pointer to where the process id is stored
+ * @return -1 on error; 0 on success
+ */
+int plist_out(plist_t *list, int *pid);
+
+/**
+ * Removes a process from whichever list it is on
+ * @param  pid - the process to remove
+ * @return -1 if the process is not on a list; 0 on success
+ */
+int plist_remove(int pid);
+
+#endif
@@ -11,29 +11,17 @@
 
 /**
  * Initializes an empty queue
- * Sets the empty queue items to -1
  *
  * @param  queue - pointer to the queue
  * @return -1 on error; 0 on success
  */
 int queue_init(queue_t *queue) {
-
-    size_t i;	
-
     if(queue == NULL){
         printf("QUEUE is empty!\n");
         return -1;
     }
 
-    // Populate all queue items with the QUEUE_EMPTY_VALUE
-	for(i = 0; i < QUEUE_SIZE; i++){
-
-		queue->items[i] = QUEUE_EMPTY_VALUE; 
-	}	
-    // Initialize all queue member values to default
-    queue->head = 0;
-    queue->tail = 0;
-    queue->size = 0;
+    queue_ring_init(queue);
 
     return 0;
 }
@@ -45,23 +33,8 @@ int queue_init(queue_t *queue) {
  * @return -1 on error; 0 on success
  */
 int queue_in(queue_t *queue, int item) {
-    // Return an error if the queue is full
-    if (queue->size == QUEUE_SIZE) {
-		return -1;
-    }
-
-    queue->items[queue->tail] = item; // Add the item to the tail of the queue
-    queue->tail=queue->tail +1;       // Move the tail to beginning
-
-    if(queue->tail == QUEUE_SIZE){
-
-        queue->tail = 0;
-
-    }
-
-    queue->size = queue->size + 1;
-
-    return 0;
+    // Returns an error if the queue is full
+    return queue_ring_put(queue, &item);
 }
 
 /**
@@ -70,25 +43,10 @@ int queue_in(queue_t *queue, int item) {
  * @return -1 on error; 0 on success
  */
 int queue_out(queue_t *queue, int *item) {
-
-	if (queue == NULL){
-        // return -1 if queue is empty
+    if (queue == NULL) {
         return -1;
     }
-    
-        // Get the item from the head of the queue
-        *item = queue->items[queue->head];
-        // Reset the empty item
-		queue->items[queue->head] = QUEUE_EMPTY_VALUE;
-        // Move the head forward
-        queue->head = queue->head + 1;
-        // If we are at the end of the array, move the head to the beginning
-        if(queue->head == QUEUE_SIZE) { 
-            queue->head = 0;
-            
-        }
-        // Decrement size (since we just removed an item from the queue)
-        queue->size--;    
-    
-    return 0;
+
+    // Returns an error if the queue is empty
+    return queue_ring_get(queue, item);
 }
@@ -9,20 +9,14 @@
 #define QUEUE_H
 
 #include "global.h"
+#include "ring.h"
 
-// Queue size
-#define QUEUE_SIZE PROC_MAX
-
-// Value for empty queue items
-#define QUEUE_EMPTY_VALUE -1
+// Queue size (a power of two large enough to hold every process)
+#define QUEUE_SIZE RING_POW2(PROC_MAX)
 
 // Queue data structure
-typedef struct {
-    int items[QUEUE_SIZE];  // queue items
-    int head;               // queue head
-    int tail;               // queue tail
-    int size;               // queue size
-} queue_t;
+RING_DEFINE(queue_ring, int, QUEUE_SIZE)
+typedef queue_ring_t queue_t;
 
 /**
  * Function declarations
@@ -30,7 +24,6 @@ typedef struct {
 
 /**
  * Initializes an empty queue
- * Sets the empty queue items to -1
  *
  * @param  queue - pointer to the queue
  * @return -1 on error; 0 on success
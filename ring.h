@@ -0,0 +1,79 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Ring Buffer Utilities
+ *
+ * RING_DEFINE(name, type, size) generates a ring buffer type name_t that
+ * holds up to size items of the given type, along with the functions:
+ *
+ *   void name_init(name_t *ring)
+ *   int  name_size(name_t *ring)
+ *   int  name_full(name_t *ring)
+ *   int  name_empty(name_t *ring)
+ *   int  name_put(name_t *ring, const type *item)  -1 if full; 0 on success
+ *   int  name_get(name_t *ring, type *item)        -1 if empty; 0 on success
+ *
+ * The size must be a power of two. The head and tail are free-running
+ * counters that are masked on access, so there is no wraparound compare
+ * and no slot needs to be reset when an item is removed.
+ */
+#ifndef RING_H
+#define RING_H
+
+// Rounds n up to the next power of two (for n up to 65536)
+// Usable in constant expressions such as array sizes
+#define RING_POW2(n) \
+    ((n) <= 1 ? 1 : (n) <= 2 ? 2 : (n) <= 4 ? 4 : (n) <= 8 ? 8 : \
+     (n) <= 16 ? 16 : (n) <= 32 ? 32 : (n) <= 64 ? 64 : (n) <= 128 ? 128 : \
+     (n) <= 256 ? 256 : (n) <= 512 ? 512 : (n) <= 1024 ? 1024 : \
+     (n) <= 2048 ? 2048 : (n) <= 4096 ? 4096 : (n) <= 8192 ? 8192 : \
+     (n) <= 16384 ? 16384 : (n) <= 32768 ? 32768 : 65536)
+
+#define RING_DEFINE(name, type, size)                                       \
+                                                                            \
+typedef char name##_size_must_be_pow2[((size) & ((size) - 1)) == 0 ? 1 : -1]; \
+                                                                            \
+typedef struct {                                                            \
+    type items[size];       /* ring items */                                \
+    unsigned int head;      /* count of items removed */                    \
+    unsigned int tail;      /* count of items added */                      \
+} name##_t;                                                                 \
+                                                                            \
+static __inline__ void name##_init(name##_t *ring) {                        \
+    ring->head = 0;                                                         \
+    ring->tail = 0;                                                         \
+}                                                                           \
+                                                                            \
+static __inline__ int name##_size(name##_t *ring) {                         \
+    return ring->tail - ring->head;                                         \
+}                                                                           \
+                                                                            \
+static __inline__ int name##_full(name##_t *ring) {                         \
+    return ring->tail - ring->head == (size);                               \
+}                                                                           \
+                                                                            \
+static __inline__ int name##_empty(name##_t *ring) {                        \
+    return ring->tail == ring->head;                                        \
+}                                                                           \
+                                                                            \
+static __inline__ int name##_put(name##_t *ring, const type *item) {        \
+    if (ring->tail - ring->head == (size)) {                                \
+        return -1;                                                          \
+    }                                                                       \
+    ring->items[ring->tail & ((size) - 1)] = *item;                         \
+    ring->tail++;                                                           \
+    return 0;                                                               \
+}                                                                           \
+                                                                            \
+static __inline__ int name##_get(name##_t *ring, type *item) {              \
+    if (ring->tail == ring->head) {                                         \
+        return -1;                                                          \
+    }                                                                       \
+    *item = ring->items[ring->head & ((size) - 1)];                         \
+    ring->head++;                                                           \
+    return 0;                                                               \
+}
+
+#endif
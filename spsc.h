@@ -0,0 +1,89 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Single-Producer/Single-Consumer Ring Buffers
+ *
+ * SPSC_DEFINE(name, type, size) generates a lock-free ring buffer type
+ * name_t for exactly one producer (e.g. an interrupt service routine) and
+ * exactly one consumer (e.g. the kernel), along with the functions:
+ *
+ *   void name_init(name_t *ring)
+ *   int  name_size(name_t *ring)
+ *   int  name_put(name_t *ring, const type *item)    producer; -1 if full
+ *   int  name_get(name_t *ring, type *item)          consumer; -1 if empty
+ *   int  name_drain(name_t *ring, type *items, int max)
+ *                                                    consumer; items taken
+ *
+ * The tail is only written by the producer and the head is only written
+ * by the consumer, so neither side needs to mask interrupts. Each side
+ * publishes its counter after the item access it guards; SPSC_BARRIER()
+ * keeps the compiler from reordering across it, and x86 does not reorder
+ * stores with stores or loads with loads.
+ *
+ * The size must be a power of two.
+ */
+#ifndef SPSC_H
+#define SPSC_H
+
+// Compiler barrier: memory accesses may not be moved across it
+#define SPSC_BARRIER() __asm__ __volatile__("" : : : "memory")
+
+#define SPSC_DEFINE(name, type, size)                                       \
+                                                                            \
+typedef char name##_size_must_be_pow2[((size) & ((size) - 1)) == 0 ? 1 : -1]; \
+                                                                            \
+typedef struct {                                                            \
+    type items[size];               /* ring items */                        \
+    volatile unsigned int head;     /* items removed; consumer only */      \
+    volatile unsigned int tail;     /* items added; producer only */        \
+} name##_t;                                                                 \
+                                                                            \
+static __inline__ void name##_init(name##_t *ring) {                        \
+    ring->head = 0;                                                         \
+    ring->tail = 0;                                                         \
+}                                                                           \
+                                                                            \
+static __inline__ int name##_size(name##_t *ring) {                         \
+    return ring->tail - ring->head;                                         \
+}                                                                           \
+                                                                            \
+static __inline__ int name##_put(name##_t *ring, const type *item) {        \
+    unsigned int tail = ring->tail;                                         \
+    if (tail - ring->head == (size)) {                                      \
+        return -1;                                                          \
+    }                                                                       \
+    ring->items[tail & ((size) - 1)] = *item;                               \
+    SPSC_BARRIER();         /* item is written before it is published */    \
+    ring->tail = tail + 1;                                                  \
+    return 0;                                                               \
+}                                                                           \
+                                                                            \
+static __inline__ int name##_get(name##_t *ring, type *item) {              \
+    unsigned int head = ring->head;                                         \
+    if (ring->tail == head) {                                               \
+        return -1;                                                          \
+    }                                                                       \
+    SPSC_BARRIER();         /* tail is read before the item */              \
+    *item = ring->items[head & ((size) - 1)];                               \
+    SPSC_BARRIER();         /* item is read before its slot is released */  \
+    ring->head = head + 1;                                                  \
+    return 0;                                                               \
+}                                                                           \
+                                                                            \
+static __inline__ int name##_drain(name##_t *ring, type *items, int max) {  \
+    unsigned int head = ring->head;                                         \
+    unsigned int tail = ring->tail;                                         \
+    int n = 0;                                                              \
+    SPSC_BARRIER();         /* tail is read before the items */             \
+    while (head != tail && n < max) {                                       \
+        items[n++] = ring->items[head & ((size) - 1)];                      \
+        head++;                                                             \
+    }                                                                       \
+    SPSC_BARRIER();         /* items are read before the slots are released */ \
+    ring->head = head;                                                      \
+    return n;                                                               \
+}
+
+#endif
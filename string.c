@@ -25,16 +25,17 @@ void *sp_memset(void *dest, int c, size_t n) {
 
 //using this function to intialize a region of memory to some known value
 
-    int i;
+    unsigned char *_dest = (unsigned char *)dest;
+    size_t i;
+
+    if(dest == 0){
+        return 0;
+    }
 
-     if(dest == '\0'){
-         return '\0';
-     }else{
-        for (i = 0; i < n; i++){
-            (char*)dest = c;
-            dest = (char*)dest++;
-        }
+    for (i = 0; i < n; i++){
+        _dest[i] = (unsigned char)c;
     }
+
     return dest;
 }
 
@@ -48,16 +49,16 @@ void *sp_memset(void *dest, int c, size_t n) {
  */
 void *sp_memcpy(void *dest, const void *src, size_t n) {
     /* !! Code Needed !! */
-    int i;
-    
-    char *_src = (char *)src;
+    size_t i;
+
+    const char *_src = (const char *)src;
     char *_dest = (char *)dest;
-    if(dest == '\0'){
-        return '\0';
-    }else{
-        for (i = 0; i < n;i++){
-            *_dest = *_src;
-        }
+    if(dest == 0){
+        return 0;
+    }
+
+    for (i = 0; i < n; i++){
+        _dest[i] = _src[i];
     }
 
     return dest;
@@ -90,26 +91,18 @@ char *sp_strcpy(char *dest, const char *src){
  */
 char *sp_strncpy(char *dest, const char *src, size_t n){
 
-    int i;
-	//Copies up to n characters from the source string src to the destination string dest
-	if(strlen(src) >= n){	//check if it's more or equal to n
-		for(i = 0; i < n; i++){
-			*dest = *src;
-			src = src++;
-			dest = dest++;
-		}
-	}else{	//if less than n
-		for(i = 0; i < strlen(src); i++){
-			*dest = *src;
-			src = src++;
-			dest = dest++;
-		}
-		for(i = strlen(src); i < n; i++){ //fills the rest with NULL
-			*dest = '\0';
-			dest = dest++;
-		}
-	}
-	return dest;
+    size_t i;
+
+    //Copies up to n characters from the source string src to the destination string dest
+    for (i = 0; i < n && src[i] != '\0'; i++){
+        dest[i] = src[i];
+    }
+
+    for (; i < n; i++){ //fills the rest with NULL
+        dest[i] = '\0';
+    }
+
+    return dest;
 }
 
 /**
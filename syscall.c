@@ -2,6 +2,7 @@
 #include "syscall_common.h"
 #include "kernel.h"
 #include "spede.h"
+#include "string.h"
 
 /*
  * Anatomy of a system call
@@ -72,6 +73,26 @@ int get_sys_time() {
     return time;
 }
 
+void get_idle_stats(idle_stats_t *stats) {
+    asm("movl %0, %%eax;"
+        "movl %1, %%ebx;"
+        "int $0x80;"
+        :
+        : "g"(SYSCALL_GET_IDLE_STATS),
+          "g"(stats)
+        : "eax", "ebx");
+}
+
+void get_mem_stats(mem_stats_t *stats) {
+    asm("movl %0, %%eax;"
+        "movl %1, %%ebx;"
+        "int $0x80;"
+        :
+        : "g"(SYSCALL_GET_MEM_STATS),
+          "g"(stats)
+        : "eax", "ebx");
+}
+
 int get_proc_pid() {
 
     int pid = -1;
@@ -103,6 +124,190 @@ int get_proc_name(char *name) {
 
 }
 
+int set_proc_prio(int pid, int prio) {
+    int rc = -1;
+
+    asm("movl %1, %%eax;"
+        "movl %2, %%ebx;"
+        "movl %3, %%ecx;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(rc)
+        : "g"(SYSCALL_SET_PROC_PRIO),
+          "g"(pid), "g"(prio)
+        : "eax", "ebx", "ecx");
+
+    return rc;
+}
+
+int set_proc_quantum(int pid, int ticks) {
+    int rc = -1;
+
+    asm("movl %1, %%eax;"
+        "movl %2, %%ebx;"
+        "movl %3, %%ecx;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(rc)
+        : "g"(SYSCALL_SET_PROC_QUANTUM),
+          "g"(pid), "g"(ticks)
+        : "eax", "ebx", "ecx");
+
+    return rc;
+}
+
+int set_proc_nice(int pid, int nice) {
+    int rc = -1;
+
+    asm("movl %1, %%eax;"
+        "movl %2, %%ebx;"
+        "movl %3, %%ecx;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(rc)
+        : "g"(SYSCALL_SET_PROC_NICE),
+          "g"(pid), "g"(nice)
+        : "eax", "ebx", "ecx");
+
+    return rc;
+}
+
+int sched_set_deadline(int period, int runtime, int deadline) {
+    int rc = -1;
+
+    asm("movl %1, %%eax;"
+        "movl %2, %%ebx;"
+        "movl %3, %%ecx;"
+        "movl %4, %%edx;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(rc)
+        : "g"(SYSCALL_SCHED_SET_DEADLINE),
+          "g"(period), "g"(runtime), "g"(deadline)
+        : "eax", "ebx", "ecx", "edx");
+
+    return rc;
+}
+
+int sched_yield_period() {
+    int rc = -1;
+
+    asm("movl %1, %%eax;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(rc)
+        : "g"(SYSCALL_SCHED_YIELD_PERIOD)
+        : "eax", "ebx");
+
+    return rc;
+}
+
+int sched_get_deadline_stats(int pid, dl_stats_t *stats) {
+    int rc = -1;
+
+    asm("movl %1, %%eax;"
+        "movl %2, %%ebx;"
+        "movl %3, %%ecx;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(rc)
+        : "g"(SYSCALL_SCHED_GET_DEADLINE_STATS),
+          "g"(pid), "g"(stats)
+        : "eax", "ebx", "ecx");
+
+    return rc;
+}
+
+int get_stack_stats(int pid, stack_stats_t *stats) {
+    int rc = -1;
+
+    asm("movl %1, %%eax;"
+        "movl %2, %%ebx;"
+        "movl %3, %%ecx;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(rc)
+        : "g"(SYSCALL_GET_STACK_STATS),
+          "g"(pid), "g"(stats)
+        : "eax", "ebx", "ecx");
+
+    return rc;
+}
+
+void *proc_sbrk(int increment) {
+    void *brk = NULL;
+
+    asm("movl %1, %%eax;"
+        "movl %2, %%ebx;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(brk)
+        : "g"(SYSCALL_PROC_SBRK),
+          "g"(increment)
+        : "eax", "ebx");
+
+    return brk;
+}
+
+int proc_fork(void) {
+    int pid = -1;
+
+    asm("movl %1, %%eax;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(pid)
+        : "g"(SYSCALL_PROC_FORK)
+        : "eax", "ebx");
+
+    return pid;
+}
+
+int shm_create(char *name, int size) {
+    int id = -1;
+
+    asm("movl %1, %%eax;"
+        "movl %2, %%ebx;"
+        "movl %3, %%ecx;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(id)
+        : "g"(SYSCALL_SHM_CREATE),
+          "g"(name), "g"(size)
+        : "eax", "ebx", "ecx");
+
+    return id;
+}
+
+void *shm_attach(int id) {
+    void *addr = NULL;
+
+    asm("movl %1, %%eax;"
+        "movl %2, %%ebx;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(addr)
+        : "g"(SYSCALL_SHM_ATTACH),
+          "g"(id)
+        : "eax", "ebx");
+
+    return addr;
+}
+
+int shm_detach(void *addr) {
+    int rc = -1;
+
+    asm("movl %1, %%eax;"
+        "movl %2, %%ebx;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(rc)
+        : "g"(SYSCALL_SHM_DETACH),
+          "g"(addr)
+        : "eax", "ebx");
+
+    return rc;
+}
+
 void sleep(int seconds) {
 
     asm("movl %0, %%eax;"
@@ -142,12 +347,28 @@ void sem_post(sem_t *sem){
         "movl %1, %%ebx;"
         "int $0x80;"
         :
-        : "g"(SYSCALL_SEM_WAIT),
+        : "g"(SYSCALL_SEM_POST),
           "g"(sem)
         : "eax", "ebx");
 
 }
 
+int sem_timedwait(sem_t *sem, int ms){
+    int rc = -1;
+
+    asm("movl %1, %%eax;"
+        "movl %2, %%ebx;"
+        "movl %3, %%ecx;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(rc)
+        : "g"(SYSCALL_SEM_TIMEDWAIT),
+          "g"(sem), "g"(ms)
+        : "eax", "ebx", "ecx");
+
+    return rc;
+}
+
 void msg_send(msg_t *msg, int mbox_num){
     asm("movl %0, %%eax;"
         "movl %1, %%ebx;"
@@ -160,15 +381,134 @@ void msg_send(msg_t *msg, int mbox_num){
 }
 
 void msg_recv(msg_t *msg, int mbox_num){
+    msg_recv_size(msg, mbox_num, MSG_SIZE);
+}
+
+void msg_recv_size(msg_t *msg, int mbox_num, int size){
     asm("movl %0, %%eax;"
         "movl %1, %%ebx;"
         "movl %2, %%ecx;"
+        "movl %3, %%edx;"
         "int $0x80;"
         :
         : "g"(SYSCALL_MSG_RECV),
-          "g"(msg),"g"(mbox_num)
+          "g"(msg),"g"(mbox_num),"g"(size)
+        : "eax", "ebx", "ecx", "edx");
+}
+
+int msg_tryrecv(msg_t *msg, int mbox_num) {
+    return msg_recv_timeout(msg, mbox_num, 0);
+}
+
+int msg_recv_timeout(msg_t *msg, int mbox_num, int ms) {
+    int rc = -1;
+
+    asm("movl %1, %%eax;"
+        "movl %2, %%ebx;"
+        "movl %3, %%ecx;"
+        "movl %4, %%edx;"
+        "movl %5, %%esi;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(rc)
+        : "g"(SYSCALL_MSG_RECV_TIMEOUT),
+          "g"(msg), "g"(mbox_num), "g"(MSG_SIZE), "g"(ms)
+        : "eax", "ebx", "ecx", "edx", "esi");
+
+    return rc;
+}
+
+int msg_select(ipc_set_t *set, int ms) {
+    int rc = -1;
+
+    asm("movl %1, %%eax;"
+        "movl %2, %%ebx;"
+        "movl %3, %%ecx;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(rc)
+        : "g"(SYSCALL_MSG_SELECT),
+          "g"(set), "g"(ms)
         : "eax", "ebx", "ecx");
+
+    // The set only holds the ready ones when something is ready
+    if (rc <= 0) {
+        sp_memset(set, 0, sizeof(ipc_set_t));
+    }
+
+    return rc;
 }
 
+int msg_sendv(msg_t *msgs, int count, int mbox_num) {
+    int rc = 0;
+
+    asm("movl %1, %%eax;"
+        "movl %2, %%ebx;"
+        "movl %3, %%ecx;"
+        "movl %4, %%edx;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(rc)
+        : "g"(SYSCALL_MSG_SENDV),
+          "g"(msgs), "g"(mbox_num), "g"(count)
+        : "eax", "ebx", "ecx", "edx");
+
+    return rc;
+}
 
+int msg_recvv(msg_t *msgs, int max, int mbox_num, int flags) {
+    int rc = 0;
 
+    asm("movl %1, %%eax;"
+        "movl %2, %%ebx;"
+        "movl %3, %%ecx;"
+        "movl %4, %%edx;"
+        "movl %5, %%esi;"
+        "movl %6, %%edi;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(rc)
+        : "g"(SYSCALL_MSG_RECVV),
+          "g"(msgs), "g"(mbox_num), "g"(MSG_SIZE), "g"(max), "g"(flags)
+        : "eax", "ebx", "ecx", "edx", "esi", "edi");
+
+    return rc;
+}
+
+int msg_send_pages(void *buf, int pages, int mbox_num) {
+    int rc = -1;
+
+    asm("movl %1, %%eax;"
+        "movl %2, %%ebx;"
+        "movl %3, %%ecx;"
+        "movl %4, %%edx;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        : "=g"(rc)
+        : "g"(SYSCALL_MSG_SEND_PAGES),
+          "g"(buf), "g"(pages), "g"(mbox_num)
+        : "eax", "ebx", "ecx", "edx");
+
+    return rc;
+}
+
+void *msg_recv_pages(int mbox_num, int *pages) {
+    void *addr = NULL;
+    int count = 0;
+
+    asm("movl %2, %%eax;"
+        "movl %3, %%ebx;"
+        "int $0x80;"
+        "movl %%ebx, %0;"
+        "movl %%ecx, %1;"
+        : "=g"(addr), "=g"(count)
+        : "g"(SYSCALL_MSG_RECV_PAGES),
+          "g"(mbox_num)
+        : "eax", "ebx", "ecx");
+
+    if (pages != NULL) {
+        *pages = count;
+    }
+
+    return addr;
+}
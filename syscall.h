@@ -2,6 +2,7 @@
 #define SYSCALL_H
 
 #include "ipc.h"
+#include "syscall_common.h"
 
 /*
  * Exits the current process
@@ -14,6 +15,18 @@ void proc_exit(void);
  */
 int get_sys_time(void);
 
+/*
+ * Gets the idle task statistics
+ * @param stats - pointer to the structure where the statistics will be copied
+ */
+void get_idle_stats(idle_stats_t *stats);
+
+/*
+ * Gets the physical memory statistics
+ * @param stats - pointer to the structure where the statistics will be copied
+ */
+void get_mem_stats(mem_stats_t *stats);
+
 /*
  * Gets the current process' id
  * @return process id
@@ -27,6 +40,86 @@ int get_proc_pid(void);
  */
 int get_proc_name(char *name);
 
+/*
+ * Sets the scheduling priority of a process
+ * @param pid  - the process id to change
+ * @param prio - the new priority; 0 is the highest
+ * @return 0 on success, -1 on error
+ */
+int set_proc_prio(int pid, int prio);
+
+/*
+ * Sets the time slice of a process
+ * @param pid   - the process id to change
+ * @param ticks - number of timer ticks the process may run before
+ *                being preempted
+ * @return 0 on success, -1 on error
+ */
+int set_proc_quantum(int pid, int ticks);
+
+/*
+ * Moves a process into the fair scheduling class
+ * Fair class processes share the CPU in proportion to their weights and
+ * only run when no priority class process is runnable
+ * @param pid  - the process id to change
+ * @param nice - nice value from -20 (largest share) to 19 (smallest)
+ * @return 0 on success, -1 on error
+ */
+int set_proc_nice(int pid, int nice);
+
+/*
+ * Moves the current process into the earliest deadline first class
+ * The process may run for runtime ticks in every period, and each
+ * period's work must complete within deadline ticks of the period start
+ * EDF processes run ahead of all other processes
+ * @param period   - activation period in ticks
+ * @param runtime  - CPU budget per period in ticks; 0 leaves the EDF class
+ * @param deadline - relative deadline in ticks, runtime <= deadline <= period
+ * @return 0 on success, -1 if invalid or rejected by admission control
+ */
+int sched_set_deadline(int period, int runtime, int deadline);
+
+/*
+ * Ends the current period's work of an EDF process
+ * The process sleeps until its next period starts, with a fresh budget
+ * @return 0 once the next period starts, -1 if not in the EDF class
+ */
+int sched_yield_period();
+
+/*
+ * Gets the deadline scheduling statistics of a process
+ * @param pid   - the process id
+ * @param stats - pointer to the structure where the statistics will be copied
+ * @return 0 on success, -1 on error
+ */
+int sched_get_deadline_stats(int pid, dl_stats_t *stats);
+
+/*
+ * Gets the stack statistics of a process
+ * The high-water mark is only measured when the kernel is built with
+ * PROC_STACK_WATERMARK
+ * @param pid   - the process id
+ * @param stats - pointer to the structure where the statistics will be copied
+ * @return 0 on success, -1 on error
+ */
+int get_stack_stats(int pid, stack_stats_t *stats);
+
+/*
+ * Grows or shrinks the heap of the current process
+ * Heap pages are zero-filled and only given memory when first touched
+ * @param increment - number of bytes to add (or remove if negative)
+ * @return the previous end of the heap; NULL on error
+ */
+void *proc_sbrk(int increment);
+
+/*
+ * Duplicates the current process
+ * The child gets a copy of the stack and shares the heap copy-on-write
+ * Global variables are not copied; parent and child share them
+ * @return the child's process id in the parent, 0 in the child, -1 on error
+ */
+int proc_fork(void);
+
 /*
  * Puts the current process to sleep for the specified number of seconds
  * @param seconds - number of seconds the process should sleep
@@ -48,6 +141,16 @@ void sem_init(sem_t *sem);
  */
 void sem_wait(sem_t *sem);
 
+/*
+ * Wait on a semaphore for a limited time
+ * @param sem - pointer to semaphore identifier
+ * @param ms - milliseconds to wait; IPC_FOREVER waits indefinitely and
+ *             0 only takes the semaphore if it is free
+ * @return 0 once the semaphore is taken, IPC_TIMEOUT if the time ran
+ *         out first, -1 on error
+ */
+int sem_timedwait(sem_t *sem, int ms);
+
 /*
  * Post a semaphore
  * @param sem - pointer to semaphore identifier
@@ -56,18 +159,137 @@ void sem_wait(sem_t *sem);
  */
 void sem_post(sem_t *sem);
 
+/*
+ * Creates a zero-filled shared memory segment, or finds an existing one
+ * A new segment is kept for its creator until the creator detaches it or
+ * exits, even if it is never attached
+ * @param name - segment name (up to 16 characters)
+ * @param size - segment size in bytes (up to 4 MB); must match the size
+ *               of an existing segment
+ * @return the segment id, -1 on error
+ */
+int shm_create(char *name, int size);
+
+/*
+ * Maps a shared memory segment into the current process
+ * The segment is mapped at the same address in every process
+ * @param id - the segment id
+ * @return the address of the segment, NULL on error
+ */
+void *shm_attach(int id);
+
+/*
+ * Unmaps a shared memory segment from the current process
+ * The segment is freed once no process has it mapped and its creator
+ * has detached it or exited
+ * @param addr - address returned by shm_attach
+ * @return 0 on success, -1 on error
+ */
+int shm_detach(void *addr);
+
 /*
  * Send a message
+ * Only msg->size data bytes (at most MSG_SIZE_MAX) are sent; the kernel
+ * sets the sender and time sent
  * @param msg - pointer to the local message data structure
  * @param mbox_num - the mailbox to send the message to
  */
 void msg_send(msg_t *msg, int mbox_num);
 
 /*
- * Receive a message
+ * Receive a message into a msg_t
  * @param msg - pointer to the local message data structure
  * @param mbox_num - the mailbox to receive the message from
  */
 void msg_recv(msg_t *msg, int mbox_num);
 
+/*
+ * Receive a message into a message declared with MSG_DEFINE
+ * At most size data bytes are copied; msg->size is set to the size that
+ * was sent, so a larger value means the message was truncated
+ * @param msg - pointer to the local message data structure
+ * @param mbox_num - the mailbox to receive the message from
+ * @param size - number of data bytes the message can hold
+ */
+void msg_recv_size(msg_t *msg, int mbox_num, int size);
+
+/*
+ * Receive a message only if one is already queued
+ * @param msg - pointer to the local message data structure
+ * @param mbox_num - the mailbox to receive the message from
+ * @return 1 if a message was received, 0 if the mailbox is empty, -1 on
+ *         error
+ */
+int msg_tryrecv(msg_t *msg, int mbox_num);
+
+/*
+ * Receive a message, waiting for a limited time
+ * @param msg - pointer to the local message data structure
+ * @param mbox_num - the mailbox to receive the message from
+ * @param ms - milliseconds to wait; IPC_FOREVER waits indefinitely
+ * @return 1 if a message was received, IPC_TIMEOUT if the time ran out
+ *         first, 0 if ms is 0 and the mailbox is empty, -1 on error
+ */
+int msg_recv_timeout(msg_t *msg, int mbox_num, int ms);
+
+/*
+ * Wait until one of several mailboxes has a message or one of several
+ * semaphores is free
+ * Nothing is received or taken; follow up with msg_tryrecv or
+ * sem_timedwait(sem, 0) on the ready ones
+ * @param set - mailboxes and semaphores to wait on, added with
+ *              IPC_SET_ADD(set->mbox, mbox_num) and IPC_SET_ADD(set->sem,
+ *              sem); replaced with the ones that are ready, or emptied if
+ *              none are
+ * @param ms - milliseconds to wait; IPC_FOREVER waits indefinitely and
+ *             0 only checks
+ * @return number of ready mailboxes and semaphores, 0 if ms is 0 and none
+ *         are ready, IPC_TIMEOUT if the time ran out first, -1 on error
+ */
+int msg_select(ipc_set_t *set, int ms);
+
+/*
+ * Send a batch of messages in one system call
+ * Each message carries at most MSG_SIZE data bytes; sending stops at the
+ * first message that is invalid or does not fit in the mailbox
+ * @param msgs - array of messages
+ * @param count - number of messages (at most MSG_BATCH_MAX)
+ * @param mbox_num - the mailbox to send the messages to
+ * @return number of messages sent
+ */
+int msg_sendv(msg_t *msgs, int count, int mbox_num);
+
+/*
+ * Receive a batch of messages in one system call
+ * Every queued message, up to max, is received. If none are queued the
+ * call waits for one, or returns 0 right away if MSG_NOWAIT is set
+ * @param msgs - array of messages
+ * @param max - size of the array (at most MSG_BATCH_MAX are received)
+ * @param mbox_num - the mailbox to receive the messages from
+ * @param flags - MSG_NOWAIT or 0
+ * @return number of messages received
+ */
+int msg_recvv(msg_t *msgs, int max, int mbox_num, int flags);
+
+/*
+ * Send whole heap pages without copying them
+ * The pages are unmapped from the sender and mapped into the receiver;
+ * if the sender touches the range again it reads as zero. Use msg_send
+ * for small messages.
+ * @param buf      - page aligned address in the heap (see proc_sbrk)
+ * @param pages    - number of pages, up to MSG_PAGES_MAX
+ * @param mbox_num - the mailbox to send the pages to
+ * @return 0 on success, -1 on error
+ */
+int msg_send_pages(void *buf, int pages, int mbox_num);
+
+/*
+ * Receive pages sent with msg_send_pages
+ * The pages are mapped at the end of the receiver's heap
+ * @param mbox_num - the mailbox to receive the pages from
+ * @param pages    - set to the number of pages received
+ * @return address of the pages, NULL on error
+ */
+void *msg_recv_pages(int mbox_num, int *pages);
+
 #endif
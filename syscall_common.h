@@ -19,7 +19,68 @@ typedef enum {
     SYSCALL_SEM_WAIT,
     SYSCALL_SEM_POST,
     SYSCALL_MSG_SEND,
-    SYSCALL_MSG_RECV
+    SYSCALL_MSG_RECV,
+    SYSCALL_SET_PROC_PRIO,
+    SYSCALL_SET_PROC_QUANTUM,
+    SYSCALL_SET_PROC_NICE,
+    SYSCALL_GET_IDLE_STATS,
+    SYSCALL_SCHED_SET_DEADLINE,
+    SYSCALL_SCHED_GET_DEADLINE_STATS,
+    SYSCALL_GET_MEM_STATS,
+    SYSCALL_GET_STACK_STATS,
+    SYSCALL_PROC_SBRK,
+    SYSCALL_PROC_FORK,
+    SYSCALL_SHM_CREATE,
+    SYSCALL_SHM_ATTACH,
+    SYSCALL_SHM_DETACH,
+    SYSCALL_MSG_SEND_PAGES,
+    SYSCALL_MSG_RECV_PAGES,
+    SYSCALL_MSG_SENDV,
+    SYSCALL_MSG_RECVV,
+    SYSCALL_MSG_RECV_TIMEOUT,
+    SYSCALL_SEM_TIMEDWAIT,
+    SYSCALL_MSG_SELECT,
+    SYSCALL_SCHED_YIELD_PERIOD
 } syscall_t;
 
+// Idle statistics
+typedef struct {
+    int idle_ticks;                 // ticks spent in the idle task
+    int total_ticks;                // ticks since the kernel started
+    int halts;                      // times the idle task halted the CPU
+    int avg_halt_ticks;             // average ticks per halt
+} idle_stats_t;
+
+// Deadline scheduling statistics
+typedef struct {
+    int period;                     // activation period in ticks
+    int runtime;                    // budget per period in ticks
+    int deadline;                   // relative deadline in ticks
+    int overruns;                   // jobs that used up the budget unfinished
+    int misses;                     // number of missed deadlines
+} dl_stats_t;
+
+// Physical memory statistics
+typedef struct {
+    int page_size;                  // bytes per page frame
+    int pages_total;                // frames managed by the kernel
+    int pages_free;                 // frames currently free
+    int alloc_fails;                // allocations that could not be satisfied
+    int page_faults;                // page faults taken
+    int zero_fills;                 // demand-zero pages mapped
+    int cr3_loads;                  // address space switches
+    int cr3_skips;                  // address space switches avoided
+    int forks;                      // processes created by proc_fork
+    int fork_copies;                // pages copied by proc_fork itself
+    int cow_copies;                 // pages copied on a write after a fork
+    int page_loans;                 // pages moved by msg_send_pages
+} mem_stats_t;
+
+// Process stack statistics
+typedef struct {
+    int size;                       // stack size in bytes
+    int used;                       // high-water mark in bytes, -1 if not measured
+    int overflow;                   // 1 if the stack canary was overwritten
+} stack_stats_t;
+
 #endif
@@ -0,0 +1,424 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Benchmark Processes
+ *
+ * Each benchmark is a user process started with a kernel command key. It
+ * prints its results to the console and exits. Throughput is measured over
+ * whole seconds of get_sys_time, and latency in timer ticks. Processes a
+ * benchmark forks share its global variables (fork only copies the stack
+ * and heap), which is how they are told to stop.
+ */
+#include "global.h"
+#include "spede.h"
+
+#include "user_bench.h"
+#include "string.h"
+#include "syscall.h"
+#include "ipc.h"
+
+/* Seconds each throughput benchmark runs for */
+#define BENCH_SECONDS 5
+
+/* get_proc_pid calls made by the system call benchmark */
+#define BENCH_SYSCALLS 1000000
+
+/* Mailboxes used by the benchmarks (the dispatcher uses mailbox 1) */
+#define BENCH_MBOX_PING (PROC_MAX - 1)
+#define BENCH_MBOX_PONG (PROC_MAX - 2)
+#define BENCH_MBOX_IDLE (PROC_MAX - 3)  // never sent to; timed receives on it just wait
+
+/* Lowest scheduling priority */
+#define BENCH_PRIO_LOW 31
+
+/* Milliseconds per timer tick */
+#define BENCH_TICK_MS 10
+
+/* Timed waits made to measure wakeup latency, and their length */
+#define BENCH_WAKEUPS 50
+#define BENCH_WAKEUP_MS 10
+
+/* Sleeping processes in the timer benchmark and the timed waits each makes */
+#define BENCH_SLEEPERS (PROC_MAX - 4)
+#define BENCH_SLEEPS 25
+
+/* Lateness a sleeper reports to the timer benchmark */
+typedef struct bench_late_t {
+    int sleeps;         // timed waits made
+    int late_sum;       // ticks late, summed
+    int late_max;       // worst ticks late
+    int on_time;        // timed waits that woke on their tick
+} bench_late_t;
+
+/* Batches the message benchmark's producer sends and its consumer receives
+   (separate arrays, since they share globals) */
+msg_t bench_msgs_out[MSG_BATCH_MAX];
+msg_t bench_msgs_in[MSG_BATCH_MAX];
+
+/* Set to tell the processes a benchmark forked to exit */
+volatile int bench_stop = 0;
+
+/* Waits for the next second to start so a run covers whole seconds */
+int bench_start() {
+    int time;
+
+    time = get_sys_time();
+    while (get_sys_time() == time) {
+        // Spin until the second changes
+    }
+
+    return time + 1;
+}
+
+/* Obtains the system time in timer ticks */
+int bench_ticks() {
+    idle_stats_t stats;
+
+    get_idle_stats(&stats);
+
+    return stats.total_ticks;
+}
+
+/* Forks a process that stays runnable at the lowest priority until stopped */
+int bench_spin_fork() {
+    int child;
+
+    child = proc_fork();
+
+    if (child == 0) {
+        while (!bench_stop) {
+            // Spin
+        }
+        proc_exit();
+    }
+
+    if (child > 0) {
+        set_proc_prio(child, BENCH_PRIO_LOW);
+    }
+
+    return child;
+}
+
+void bench_spawn_proc() {
+    int pid;
+    int child;
+    int start;
+    int spawns = 0;
+    int retries = 0;
+    char name[PROC_NAME_LEN];
+
+    sp_memset(&name, 0, sizeof(name));
+    get_proc_name(name);
+    pid = get_proc_pid();
+
+    cons_printf("time=%04d pid=%02d %s started\n", get_sys_time(), pid, name);
+
+    start = bench_start();
+
+    while (get_sys_time() < start + BENCH_SECONDS) {
+        child = proc_fork();
+
+        if (child == 0) {
+            // The child only has to exit
+            proc_exit();
+        }
+
+        if (child < 0) {
+            // Every process slot is taken until the children exit
+            retries++;
+            continue;
+        }
+
+        // Let the child run (and exit) before the next fork
+        set_proc_prio(child, 0);
+        spawns++;
+    }
+
+    cons_printf("time=%04d pid=%02d %s %d spawns in %d s (%d/s), %d forks retried\n",
+                get_sys_time(), pid, name, spawns, BENCH_SECONDS, spawns / BENCH_SECONDS, retries);
+
+    proc_exit();
+}
+
+void bench_syscall_proc() {
+    int pid;
+    int start;
+    int time;
+    int i;
+    char name[PROC_NAME_LEN];
+
+    sp_memset(&name, 0, sizeof(name));
+    get_proc_name(name);
+    pid = get_proc_pid();
+
+    cons_printf("time=%04d pid=%02d %s started\n", get_sys_time(), pid, name);
+
+    start = bench_start();
+
+    for (i = 0; i < BENCH_SYSCALLS; i++) {
+        get_proc_pid();
+    }
+
+    // The count only has whole seconds, so it rounds up to at least one
+    time = get_sys_time() - start + 1;
+
+    // Build with SYSCALL_FAST_RETURN=0 for the numbers before the fast path
+    cons_printf("time=%04d pid=%02d %s %d get_proc_pid calls in under %d s (over %d/s)\n",
+                get_sys_time(), pid, name, BENCH_SYSCALLS, time, BENCH_SYSCALLS / time);
+
+    proc_exit();
+}
+
+void bench_sched_proc() {
+    int pid;
+    int child;
+    int load;
+    int spawned;
+    int start;
+    int rounds;
+    int ticks;
+    int late;
+    int late_max;
+    int late_sum;
+    int i;
+    char name[PROC_NAME_LEN];
+
+    msg_t msg;
+
+    sp_memset(&name, 0, sizeof(name));
+    get_proc_name(name);
+    pid = get_proc_pid();
+
+    sp_memset(&msg, 0, sizeof(msg_t));
+    msg.size = sizeof(int);
+
+    cons_printf("time=%04d pid=%02d %s started\n", get_sys_time(), pid, name);
+
+    // Each pass adds more runnable processes; the scheduler should pick the
+    // next process in the same time however many are queued
+    for (load = 0; ; load = load * 2 + 1) {
+        bench_stop = 0;
+
+        for (spawned = 0; spawned < load; spawned++) {
+            if (bench_spin_fork() < 0) {
+                break;
+            }
+        }
+
+        // The partner answers every ping, so each round trip is two
+        // context switches through the scheduler
+        child = proc_fork();
+        if (child == 0) {
+            while (1) {
+                msg_recv(&msg, BENCH_MBOX_PING);
+                if (bench_stop) {
+                    proc_exit();
+                }
+                msg_send(&msg, BENCH_MBOX_PONG);
+            }
+        }
+
+        rounds = 0;
+        start = bench_start();
+
+        while (child > 0 && get_sys_time() < start + BENCH_SECONDS) {
+            msg_send(&msg, BENCH_MBOX_PING);
+            msg_recv(&msg, BENCH_MBOX_PONG);
+            rounds++;
+        }
+
+        // Wake up from short timed waits while the load is runnable
+        late_sum = 0;
+        late_max = 0;
+
+        for (i = 0; i < BENCH_WAKEUPS; i++) {
+            ticks = bench_ticks();
+            msg_recv_timeout(&msg, BENCH_MBOX_IDLE, BENCH_WAKEUP_MS);
+            late = bench_ticks() - ticks - BENCH_WAKEUP_MS / BENCH_TICK_MS;
+
+            late_sum += late;
+            if (late > late_max) {
+                late_max = late;
+            }
+        }
+
+        cons_printf("time=%04d pid=%02d %s load=%d: %d switches/s, wakeup late avg=%d max=%d ticks\n",
+                    get_sys_time(), pid, name, spawned, rounds * 2 / BENCH_SECONDS,
+                    late_sum / BENCH_WAKEUPS, late_max);
+
+        // Stop the partner and the load, then let them run so they exit
+        bench_stop = 1;
+        if (child > 0) {
+            msg_send(&msg, BENCH_MBOX_PING);
+        }
+        sleep(1);
+
+        // Done once the process table is full
+        if (spawned < load || child < 0) {
+            break;
+        }
+    }
+
+    proc_exit();
+}
+
+void bench_timer_proc() {
+    int pid;
+    int child;
+    int sleepers;
+    int ticks;
+    int late;
+    int ms;
+    int i;
+    int j;
+    char name[PROC_NAME_LEN];
+
+    msg_t msg;
+    bench_late_t result;
+    bench_late_t total;
+
+    sp_memset(&name, 0, sizeof(name));
+    get_proc_name(name);
+    pid = get_proc_pid();
+
+    cons_printf("time=%04d pid=%02d %s started\n", get_sys_time(), pid, name);
+
+    for (sleepers = 0; sleepers < BENCH_SLEEPERS; sleepers++) {
+        child = proc_fork();
+
+        if (child < 0) {
+            break;
+        }
+
+        if (child == 0) {
+            sp_memset(&result, 0, sizeof(bench_late_t));
+
+            // Mixed durations from one tick to 80 ticks, crossing the
+            // timer wheel's level boundaries
+            for (j = 0; j < BENCH_SLEEPS; j++) {
+                ms = BENCH_TICK_MS * (1 + (j * 37 + sleepers * 11) % 80);
+
+                ticks = bench_ticks();
+                msg_recv_timeout(&msg, BENCH_MBOX_IDLE, ms);
+                late = bench_ticks() - ticks - ms / BENCH_TICK_MS;
+
+                result.sleeps++;
+                result.late_sum += late;
+                if (late > result.late_max) {
+                    result.late_max = late;
+                }
+                if (late == 0) {
+                    result.on_time++;
+                }
+            }
+
+            sp_memset(&msg, 0, sizeof(msg_t));
+            sp_memcpy(msg.data, &result, sizeof(bench_late_t));
+            msg.size = sizeof(bench_late_t);
+            msg_send(&msg, BENCH_MBOX_PONG);
+            proc_exit();
+        }
+    }
+
+    // Collect the lateness of every sleeper
+    sp_memset(&total, 0, sizeof(bench_late_t));
+
+    for (i = 0; i < sleepers; i++) {
+        msg_recv(&msg, BENCH_MBOX_PONG);
+        sp_memcpy(&result, msg.data, sizeof(bench_late_t));
+
+        total.sleeps += result.sleeps;
+        total.late_sum += result.late_sum;
+        total.on_time += result.on_time;
+        if (result.late_max > total.late_max) {
+            total.late_max = result.late_max;
+        }
+    }
+
+    if (total.sleeps > 0) {
+        cons_printf("time=%04d pid=%02d %s %d sleepers, %d wakeups: %d on time, late avg=%d max=%d ticks\n",
+                    get_sys_time(), pid, name, sleepers, total.sleeps, total.on_time,
+                    total.late_sum / total.sleeps, total.late_max);
+    }
+
+    proc_exit();
+}
+
+void bench_msg_proc() {
+    int pid;
+    int child;
+    int batch;
+    int start;
+    int count;
+    int pending;
+    int sent;
+    int got;
+    int stop;
+    int i;
+    char name[PROC_NAME_LEN];
+
+    msg_t ack;
+
+    sp_memset(&name, 0, sizeof(name));
+    get_proc_name(name);
+    pid = get_proc_pid();
+
+    cons_printf("time=%04d pid=%02d %s started\n", get_sys_time(), pid, name);
+
+    for (i = 0; i < MSG_BATCH_MAX; i++) {
+        sp_memset(&bench_msgs_out[i], 0, sizeof(msg_t));
+        bench_msgs_out[i].size = sizeof(int);
+    }
+
+    sp_memset(&ack, 0, sizeof(msg_t));
+    ack.size = sizeof(int);
+
+    for (batch = 1; batch <= MSG_BATCH_MAX; batch *= 2) {
+        // The producer sends a batch at a time and waits for the consumer
+        // to acknowledge it, so the mailbox never overflows
+        child = proc_fork();
+
+        if (child < 0) {
+            break;
+        }
+
+        if (child == 0) {
+            do {
+                for (sent = 0; sent < batch; sent += msg_sendv(&bench_msgs_out[sent], batch - sent, BENCH_MBOX_PING)) {
+                    // Send whatever the mailbox has room for
+                }
+
+                msg_recv(&ack, BENCH_MBOX_PONG);
+                sp_memcpy(&stop, ack.data, sizeof(int));
+            } while (!stop);
+
+            proc_exit();
+        }
+
+        count = 0;
+        pending = 0;
+        stop = 0;
+        start = bench_start();
+
+        while (!stop) {
+            got = msg_recvv(bench_msgs_in, batch - pending, BENCH_MBOX_PING, 0);
+            count += got;
+            pending += got;
+
+            if (pending == batch) {
+                pending = 0;
+                stop = get_sys_time() >= start + BENCH_SECONDS;
+
+                sp_memcpy(ack.data, &stop, sizeof(int));
+                msg_send(&ack, BENCH_MBOX_PONG);
+            }
+        }
+
+        cons_printf("time=%04d pid=%02d %s batch=%d: %d msgs/s\n",
+                    get_sys_time(), pid, name, batch, count / BENCH_SECONDS);
+    }
+
+    proc_exit();
+}
@@ -0,0 +1,26 @@
+/**
+ * CPE/CSC 159 - Operating System Pragmatics
+ * California State University, Sacramento
+ * Spring 2021
+ *
+ * Benchmark Processes
+ */
+#ifndef USER_BENCH_H
+#define USER_BENCH_H
+
+// Process spawn/exit throughput
+void bench_spawn_proc();
+
+// Cost of a trivial system call
+void bench_syscall_proc();
+
+// Scheduler pick-next cost and wakeup latency under load
+void bench_sched_proc();
+
+// Timer wakeup lateness with many sleepers
+void bench_timer_proc();
+
+// Message throughput by batch size
+void bench_msg_proc();
+
+#endif
@@ -20,14 +20,17 @@ typedef struct proc_info_t {
     char name[PROC_NAME_LEN];
 } proc_info_t;
 
-/* "Shared" memory */
-int shared_mem;
+/* Shared memory segment used by the dispatcher and printer processes */
+#define SHARED_MEM_NAME "shared_mem"
 
 /* Mailbox number to send messages */
 int mbox_num = 1;
 
+/* Messages the dispatcher receives per system call */
+#define DISPATCH_BATCH 4
+
 /* Semaphore */
-sem_t sem;
+sem_t sem = SEMAPHORE_UNINITIALIZED;
 
 void user_proc() {
     int pid;
@@ -57,6 +60,7 @@ void user_proc() {
 
     // Set the message data for the proc_info_t struct
     sp_memcpy(msg.data, &proc_info, sizeof(proc_info_t));
+    msg.size = sizeof(proc_info_t);
 
     cons_printf("time=%04d pid=%02d %s started\n", start_time, pid, name);
 
@@ -78,8 +82,11 @@ void dispatcher_proc() {
     int pid;
     int time;
     char name[PROC_NAME_LEN];
+    int *shared_mem;
+    int count;
+    int i;
 
-    msg_t msg;
+    msg_t msgs[DISPATCH_BATCH];
     proc_info_t proc_info;
 
     sp_memset(&name, 0, sizeof(name));
@@ -90,36 +97,45 @@ void dispatcher_proc() {
 
     sem_init(&sem);
 
+    // Map the shared memory segment
+    shared_mem = shm_attach(shm_create(SHARED_MEM_NAME, sizeof(int)));
+    if (shared_mem == NULL) {
+        cons_printf("time=%04d pid=%02d %s unable to map shared memory\n", time, pid, name);
+        proc_exit();
+    }
+
     cons_printf("time=%04d pid=%02d %s started\n", time, pid, name);
 
     while (1) {
-        // Clear out the message data structure
-        sp_memset(&msg, 0, sizeof(msg_t));
-        sp_memset(&proc_info, 0, sizeof(proc_info_t));
+        // Clear out the message data structures
+        sp_memset(msgs, 0, sizeof(msgs));
 
-        // Receive a message from the mailbox
-        msg_recv(&msg, mbox_num);
+        // Receive every queued message (up to a batch) from the mailbox
+        count = msg_recvv(msgs, DISPATCH_BATCH, mbox_num, 0);
 
-        sp_memcpy(&proc_info, msg.data, sizeof(proc_info_t));
+        for (i = 0; i < count; i++) {
+            sp_memset(&proc_info, 0, sizeof(proc_info_t));
+            sp_memcpy(&proc_info, msgs[i].data, sizeof(proc_info_t));
 
-        cons_printf("time=%04d pid=%02d %s received msg(sender=%d, sent=%d, received=%d)\n",
-                    time, pid, name, msg.sender, msg.time_sent, msg.time_received);
-        cons_printf("time=%04d pid=%02d %s received data=(name=%s, start=%d, sleep=%d)\n",
-                    time, pid, name, proc_info.name, proc_info.time_start, proc_info.time_sleep);
+            cons_printf("time=%04d pid=%02d %s received msg(sender=%d, sent=%d, received=%d)\n",
+                        time, pid, name, msgs[i].sender, msgs[i].time_sent, msgs[i].time_received);
+            cons_printf("time=%04d pid=%02d %s received data=(name=%s, start=%d, sleep=%d)\n",
+                        time, pid, name, proc_info.name, proc_info.time_start, proc_info.time_sleep);
 
-        // Get the current system time
-        time = get_sys_time();
+            // Get the current system time
+            time = get_sys_time();
 
-        // Wait for the semaphore to be posted by the printer process
-        sem_wait(&sem);
+            // Wait for the semaphore to be posted by the printer process
+            sem_wait(&sem);
 
-        // Set the shared memory
-        shared_mem = proc_info.pid;
+            // Set the shared memory
+            *shared_mem = proc_info.pid;
 
-        // Post the semaphore so the printer process can access the shared memory
-        sem_post(&sem);
+            // Post the semaphore so the printer process can access the shared memory
+            sem_post(&sem);
 
-        sleep(1);
+            sleep(1);
+        }
     }
 }
 
@@ -127,6 +143,7 @@ void printer_proc() {
     int pid;
     int time;
     char name[PROC_NAME_LEN];
+    int *shared_mem;
 
     int cached_mem = -1;
 
@@ -138,6 +155,13 @@ void printer_proc() {
 
     sem_init(&sem);
 
+    // Map the shared memory segment
+    shared_mem = shm_attach(shm_create(SHARED_MEM_NAME, sizeof(int)));
+    if (shared_mem == NULL) {
+        cons_printf("time=%04d pid=%02d %s unable to map shared memory\n", time, pid, name);
+        proc_exit();
+    }
+
     cons_printf("time=%04d pid=%02d %s started\n", time, pid, name);
 
     while (1) {
@@ -146,10 +170,10 @@ void printer_proc() {
         time = get_sys_time();
 
         // Only print when we have new data
-        if (cached_mem != shared_mem) {
+        if (cached_mem != *shared_mem) {
             cons_printf("time=%04d pid=%02d %s read shared memory (last pid=%d)\n",
-                         time, pid, name, shared_mem);
-            cached_mem = shared_mem;
+                         time, pid, name, *shared_mem);
+            cached_mem = *shared_mem;
         }
 
         // Post the semaphore so the dispatcher process can access the shared memory